@@ -146,6 +146,12 @@ void Curves::plotAllTabs() {
   }
 }
 
+void Curves::refreshAllTabs() {
+  auto list = static_cast<PlotArea*>(static_cast<MainWindow*>(parent()->parent())->getPlotArea())->subWindowList();
+  for(int i=0; i<count(); i++)
+    static_cast<PlotWindow*>(list.at(i))->refreshPlot();
+}
+
 std::shared_ptr<QDomDocument> Curves::saveCurves() {
   auto doc=std::make_shared<QDomDocument>("h5PlotDataset");
   QDomElement root = doc->createElement("h5PlotDataset");
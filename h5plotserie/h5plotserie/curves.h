@@ -41,6 +41,8 @@ class Curves : public QTabWidget {
     void loadCurve(QDomDocument *doc);
     void plotCurrentTab();
     void plotAllTabs();
+    //! append the new data of all files to the curves of all tabs (after a refresh)
+    void refreshAllTabs();
     void removeTab(const QString &name);
 
   private:
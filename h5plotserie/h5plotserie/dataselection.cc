@@ -115,6 +115,8 @@ void DataSelection::addFile(const QString &name) {
     // refresh callback
     refreshFileSignal(name);
   });
+  // only the datasets of the plotted curves are refreshed (see PlotWindow::subscribe), not all datasets ever opened in the tree
+  h5f->setRefreshSubscribedOnly(true);
   h5File.emplace_back(name.toStdString(), h5f);
 
   auto *topitem = new TreeWidgetItem(QStringList(fileInfo.back().fileName()));
@@ -199,7 +201,7 @@ void DataSelection::refreshFile(const QString &name) {
   auto h5f=it->second;
   h5f->refresh();
   auto curves=static_cast<MainWindow*>(parent()->parent())->getCurves();
-  if(curves) curves->plotAllTabs();
+  if(curves) curves->refreshAllTabs();
 }
 
 shared_ptr<H5::File> DataSelection::getH5File(const boost::filesystem::path &p) const {
@@ -24,6 +24,7 @@
 #include "curves.h"
 #include "mainwindow.h"
 #include "dataselection.h"
+#include "seriesdata.h"
 
 #include <QStack>
 #include <QCloseEvent>
@@ -65,7 +66,12 @@ PlotWindow::PlotWindow(QWidget *parent) : QMdiSubWindow(parent) {
 
   plot->setCanvasBackground(Qt::white);
 
+  lodBuilder = std::make_unique<SeriesDataBuilder>();
+  plot->canvas()->installEventFilter(this);
+
   zoom = new QwtPlotZoomer(plot->canvas());
+  // the signal is emitted by other threads -> queued connection
+  connect(this, &PlotWindow::lodBuiltSignal, this, [this](){ plot->replot(); });
 
   uint linewidth=1;
   pen.append(QPen(Qt::red, linewidth));
@@ -87,10 +93,33 @@ PlotWindow::PlotWindow(QWidget *parent) : QMdiSubWindow(parent) {
   plot->insertLegend(legend,QwtPlot::BottomLegend);
 }
 
+PlotWindow::~PlotWindow() {
+  // the curve data must be destroyed before lodBuilder (and not later with the plot)
+  for(auto &c : curves) {
+    unsubscribe(c);
+    delete c.curve;
+  }
+  curves.clear();
+  lodBuilder.reset();
+}
+
+bool PlotWindow::eventFilter(QObject *watched, QEvent *event) {
+  // the canvas is repainted after the resize: the curves pass the samples for the new width
+  if(watched==plot->canvas() && event->type()==QEvent::Resize)
+    for(auto &c : curves)
+      c.data->setPixels(plot->canvas()->width());
+  return QMdiSubWindow::eventFilter(watched, event);
+}
+
 void PlotWindow::detachPlot() {
   QwtPlotItemList il = plot->itemList();
   for(auto & i : il)
     i->detach();
+  for(auto &c : curves) {
+    unsubscribe(c);
+    delete c.curve;
+  }
+  curves.clear();
   plot->replot();
   xMinValue=99e99;
   xMaxValue=-99e99;
@@ -99,107 +128,215 @@ void PlotWindow::detachPlot() {
 }
 
 namespace {
-  std::vector<double> getColumn(const std::shared_ptr<H5::File> &h5file, PlotData &pd,
-                                const QString &path, const QString &index) {
-    if(auto vsD=h5file->openChildObject<H5::VectorSerie<double> >(pd.getValue(path).toStdString()); vsD) {
-      std::vector<double> xVal(vsD->getRows());
-      vsD->getColumn(pd.getValue(index).toInt(), xVal);
-      return xVal;
-    }
-    else {
-      auto vsF=h5file->openChildObject<H5::VectorSerie<float> >(pd.getValue(path).toStdString());
-      std::vector<float> xVal(vsF->getRows());
-      vsF->getColumn(pd.getValue(index).toInt(), xVal);
-      std::vector<double> xValD;
-      xValD.reserve(xVal.size());
-      std::transform(xVal.begin(), xVal.end(), std::back_inserter(xValD), [](float x){ return x; });
-      return xValD;
+  template<class T>
+  void readColumns(H5::VectorSerie<T> *vs, const std::vector<int> &cols, const std::vector<size_t> &idx, size_t firstRow,
+                   std::vector<std::vector<double>> &ret) {
+    size_t rows=vs->getRows();
+    size_t nrRows=rows>firstRow ? rows-firstRow : 0;
+    std::vector<T> data(cols.size()*nrRows);
+    vs->getColumns(cols, firstRow, nrRows, data.data()); // all columns of this dataset in one pass
+    for(size_t i=0; i<cols.size(); ++i)
+      ret[idx[i]].assign(data.begin()+i*nrRows, data.begin()+(i+1)*nrRows);
+  }
+
+  // returns the columns given by the (path, index) keys of pd starting at row firstRow;
+  // columns of the same dataset are read together
+  std::vector<std::vector<double>> getColumns(const std::shared_ptr<H5::File> &h5file, PlotData &pd,
+                                              const std::vector<std::pair<QString, QString>> &keys, size_t firstRow) {
+    std::vector<std::vector<double>> ret(keys.size());
+    std::vector<bool> done(keys.size(), false);
+    for(size_t k=0; k<keys.size(); ++k) {
+      if(done[k])
+        continue;
+      std::string path=pd.getValue(keys[k].first).toStdString();
+      std::vector<int> cols;
+      std::vector<size_t> idx;
+      for(size_t j=k; j<keys.size(); ++j)
+        if(!done[j] && pd.getValue(keys[j].first).toStdString()==path) {
+          cols.push_back(pd.getValue(keys[j].second).toInt());
+          idx.push_back(j);
+          done[j]=true;
+        }
+      if(auto vsD=h5file->openChildObject<H5::VectorSerie<double> >(path); vsD)
+        readColumns(vsD, cols, idx, firstRow, ret);
+      else
+        readColumns(h5file->openChildObject<H5::VectorSerie<float> >(path), cols, idx, firstRow, ret);
     }
+    return ret;
   }
 }
-void PlotWindow::plotDataSet(PlotData pd, int penColor) {
-  try {
-    DataSelection *dataSelection=static_cast<MainWindow*>(parent()->parent()->parent())->getDataSelection();
-    std::shared_ptr<H5::File> h5file=dataSelection->getH5File(QString(pd.getValue("Filepath")+"/"+pd.getValue("Filename")).toStdString());
-
-    auto xVal = getColumn(h5file, pd, "x-Path", "x-Index");
-    auto yVal = getColumn(h5file, pd, "y-Path", "y-Index");
-    std::vector<double> y2Val;
-    bool useY2=false;
-    if (pd.getValue("y2-Path").length()>0) {
-      y2Val = getColumn(h5file, pd, "y2-Path", "y2-Index");
-      useY2=true;
-    }
 
-    if (xVal.size()==yVal.size()) {
+void PlotWindow::subscribe(Curve &c) {
+  PlotData &pd=c.pd;
+  DataSelection *dataSelection=static_cast<MainWindow*>(parent()->parent()->parent())->getDataSelection();
+  std::shared_ptr<H5::File> h5file=dataSelection->getH5File(QString(pd.getValue("Filepath")+"/"+pd.getValue("Filename")).toStdString());
 
-      for (double i : xVal)
-        if (!std::isnan(i)) { // xValue
-          if (i<xMinValue)
-            xMinValue=i;
-          if (i>xMaxValue)
-            xMaxValue=i;
-        }
+  std::vector<QString> keys{"x-Path", "y-Path"};
+  if (c.useY2)
+    keys.emplace_back("y2-Path");
+  std::vector<H5::Dataset*> datasets;
+  for (auto &key : keys) {
+    std::string path=pd.getValue(key).toStdString();
+    if (auto vsD=h5file->openChildObject<H5::VectorSerie<double> >(path); vsD)
+      datasets.push_back(vsD);
+    else
+      datasets.push_back(h5file->openChildObject<H5::VectorSerie<float> >(path));
+  }
+  for (auto *ds : datasets)
+    h5file->subscribe(ds);
+  c.file=h5file;
+  c.datasets=std::move(datasets);
+}
 
-      if (useY2) {
-        if ((yVal.size()==y2Val.size())) {
-          const double y2offset=pd.getValue("y2offset").toDouble();
-          const double y2gain=pd.getValue("y2gain").toDouble();
-          for (double & i : y2Val)
-            if (!std::isnan(i)) // y2Value
-              i=y2gain*i+y2offset;
-        }
-        else {
-          useY2=false;
-          QMessageBox msgBox;
-          msgBox.setText("Different sizes of y- and y2-Vector. I'm going to skip y2 data.");
-          msgBox.exec();
-        }
-      }
-
-      const double offset=pd.getValue("offset").toDouble();
-      const double gain=pd.getValue("gain").toDouble();
-      for (unsigned int i=0; i<yVal.size(); i++)
-        if (!std::isnan(yVal[i])) { // yValue
-          yVal[i]=gain*yVal[i]+offset;
-          if (useY2)
-            yVal[i]+=y2Val[i];
-          if (yVal[i]<yMinValue)
-            yMinValue=yVal[i];
-          if (yVal[i]>yMaxValue)
-            yMaxValue=yVal[i];
-        }
+void PlotWindow::unsubscribe(Curve &c) {
+  // if the file was reopened meanwhile the subscriptions are gone with the old file
+  if (auto h5file=c.file.lock(); h5file)
+    for (auto *ds : c.datasets)
+      h5file->unsubscribe(ds);
+  c.datasets.clear();
+}
 
-      for (unsigned int i=0; i<xVal.size(); i++) {
-        if (std::isnan(xVal[i]))
-          xVal[i]=.5*(xMinValue+xMaxValue);
-        if (std::isnan(yVal[i]))
-          yVal[i]=.5*(yMinValue+yMaxValue);
-      }
-
-      auto *curve = new QwtPlotCurve("Curve "+QString::number(plot->itemList().size()+1));
-      curve->attach(plot);
-      while (penColor>pen.size()-1)
-        penColor-=pen.size();
-      curve->setPen(pen[penColor]);
-      curve->setSamples(&xVal[0], &yVal[0], xVal.size());
-    }
-    else {
+bool PlotWindow::appendSamples(Curve &c) {
+  PlotData &pd=c.pd;
+  DataSelection *dataSelection=static_cast<MainWindow*>(parent()->parent()->parent())->getDataSelection();
+  std::shared_ptr<H5::File> h5file=dataSelection->getH5File(QString(pd.getValue("Filepath")+"/"+pd.getValue("Filename")).toStdString());
+
+  // only the rows not already in the curve are read
+  size_t firstRow=c.data->rawSize();
+  std::vector<std::pair<QString, QString>> keys{{"x-Path", "x-Index"}, {"y-Path", "y-Index"}};
+  if (c.useY2)
+    keys.emplace_back("y2-Path", "y2-Index");
+  auto columns = getColumns(h5file, pd, keys, firstRow);
+  auto &xVal = columns[0];
+  auto &yVal = columns[1];
+
+  if (firstRow==0) {
+    if (xVal.size()!=yVal.size()) {
       QMessageBox msgBox;
       msgBox.setText("Different sizes of x- and y-Vector. I'm going to skip these data.");
       msgBox.exec();
+      return false;
+    }
+    if (c.useY2 && yVal.size()!=columns[2].size()) {
+      c.useY2=false;
+      QMessageBox msgBox;
+      msgBox.setText("Different sizes of y- and y2-Vector. I'm going to skip y2 data.");
+      msgBox.exec();
+    }
+  }
+  // the datasets may be written row by row by another process: use the rows available in all of them
+  size_t n=std::min(xVal.size(), yVal.size());
+  if (c.useY2)
+    n=std::min(n, columns[2].size());
+  if (n==0)
+    return true;
+
+  for (size_t i=0; i<n; i++)
+    if (!std::isnan(xVal[i])) { // xValue
+      if (xVal[i]<xMinValue)
+        xMinValue=xVal[i];
+      if (xVal[i]>xMaxValue)
+        xMaxValue=xVal[i];
     }
+
+  const double offset=pd.getValue("offset").toDouble();
+  const double gain=pd.getValue("gain").toDouble();
+  const double y2offset=c.useY2 ? pd.getValue("y2offset").toDouble() : 0;
+  const double y2gain=c.useY2 ? pd.getValue("y2gain").toDouble() : 0;
+  for (size_t i=0; i<n; i++)
+    if (!std::isnan(yVal[i])) { // yValue
+      yVal[i]=gain*yVal[i]+offset;
+      if (c.useY2) // y2Value
+        yVal[i]+=y2gain*columns[2][i]+y2offset;
+      if (yVal[i]<yMinValue)
+        yMinValue=yVal[i];
+      if (yVal[i]>yMaxValue)
+        yMaxValue=yVal[i];
+    }
+
+  for (size_t i=0; i<n; i++) {
+    if (std::isnan(xVal[i]))
+      xVal[i]=.5*(xMinValue+xMaxValue);
+    if (std::isnan(yVal[i]))
+      yVal[i]=.5*(yMinValue+yMaxValue);
+  }
+
+  c.data->append(xVal.data(), yVal.data(), n);
+  return true;
+}
+
+void PlotWindow::plotDataSet(PlotData pd, int penColor) {
+  try {
+    auto data=std::make_unique<SeriesData>(*lodBuilder);
+    data->setPixels(plot->canvas()->width());
+    data->setBuiltCallback([this](){ lodBuiltSignal(); });
+    Curve c{pd, nullptr, data.get(), pd.getValue("y2-Path").length()>0, {}, {}};
+    subscribe(c);
+    bool ok=false;
+    try {
+      ok=appendSamples(c);
+    }
+    catch(...) {
+    }
+    if (!ok) {
+      unsubscribe(c);
+      return;
+    }
+
+    c.curve = new QwtPlotCurve("Curve "+QString::number(plot->itemList().size()+1));
+    c.curve->setData(data.release());
+    c.curve->attach(plot);
+    while (penColor>pen.size()-1)
+      penColor-=pen.size();
+    c.curve->setPen(pen[penColor]);
+    curves.push_back(c);
   }
   catch(...) {
     return;
   }
 }
 
-void PlotWindow::replotPlot() {
+void PlotWindow::refreshPlot() {
+  bool newSamples=false;
+  for (auto &c : curves) {
+    size_t from=c.data->rawSize();
+    try {
+      if (!appendSamples(c))
+        continue;
+    }
+    catch(...) {
+      continue;
+    }
+    if (c.data->rawSize()==from)
+      continue;
+    newSamples=true;
+    c.curve->itemChanged();
+  }
+  if (!newSamples)
+    return;
+  // the curves pass only the visible samples at level of detail to Qwt: a replot costs about the canvas width, not the number of samples
+  if (zoom->zoomRectIndex()>0) {
+    // keep the zoomed axes; the zoom base (used on zoom out) is the bounding rect of all data
+    QStack<QRectF> stack = zoom->zoomStack();
+    stack[0] = QRectF(QPointF(xMinValue, yMinValue), QPointF(xMaxValue, yMaxValue));
+    zoom->setZoomStack(stack, zoom->zoomRectIndex());
+    plot->replot();
+  }
+  else
+    updateZoomBase(); // replots with the axes auto scaled to the new data
+}
+
+void PlotWindow::updateZoomBase() {
   QStack<QRectF> stack = zoom->zoomStack();
   int index = zoom->zoomRectIndex();
   plot->setAxisAutoScale(QwtPlot::xBottom);
   plot->setAxisAutoScale(QwtPlot::yLeft);
+  zoom->setZoomBase();
+  stack[0] = zoom->zoomStack()[0];
+  zoom->setZoomStack(stack,index);
+}
+
+void PlotWindow::replotPlot() {
   if (plotGrid) {
     auto *grid = new QwtPlotGrid;
     grid->enableXMin(true);
@@ -208,9 +345,7 @@ void PlotWindow::replotPlot() {
     grid->setMinorPen(QPen(Qt::gray, 0, Qt::DotLine));
     grid->attach(plot);
   }
-  zoom->setZoomBase();
-  stack[0] = zoom->zoomStack()[0];
-  zoom->setZoomStack(stack,index);
+  updateZoomBase();
 }
 
 void PlotWindow::closeEvent(QCloseEvent *event) {
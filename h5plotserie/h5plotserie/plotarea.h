@@ -24,12 +24,22 @@
 #include <QMdiSubWindow>
 #include "qvector.h"
 #include "qpen.h"
+#include "plotdata.h"
+#include <vector>
+#include <memory>
 
 class QCloseEvent;
 
+namespace H5 {
+  class File;
+  class Dataset;
+}
+
 class PlotWindow;
-class PlotData;
+class SeriesData;
+class SeriesDataBuilder;
 class QwtPlot;
+class QwtPlotCurve;
 class QwtPlotZoomer;
 
 class PlotArea : public QMdiArea {
@@ -45,25 +55,52 @@ class PlotArea : public QMdiArea {
 };
 
 class PlotWindow : public QMdiSubWindow {
+  Q_OBJECT
 
   public:
     PlotWindow(QWidget *parent=nullptr);
+    ~PlotWindow() override;
 
     void detachPlot();
     void plotDataSet(PlotData pd, int penColor);
     void replotPlot();
+    //! append the rows written since the last plot/refresh to all curves (instead of rebuilding them)
+    void refreshPlot();
 
     void setPlotGrid(bool grid_=true) { plotGrid=grid_; }
 
   protected:
     void closeEvent(QCloseEvent *event) override;
+    //! passes the width of the resized plot canvas to the curves
+    bool eventFilter(QObject *watched, QEvent *event) override;
   
   private:
+    struct Curve {
+      PlotData pd;
+      QwtPlotCurve *curve;
+      SeriesData *data; // owned by curve
+      bool useY2;
+      std::weak_ptr<H5::File> file; // the file of the datasets (it is closed and reopened if a writer starts)
+      std::vector<H5::Dataset*> datasets; // the datasets of the curve subscribed for refresh
+    };
+    //! subscribe the datasets of the curve c for refresh (only plotted datasets are refreshed)
+    void subscribe(Curve &c);
+    void unsubscribe(Curve &c);
+    //! read the new rows of the curve c and append them; returns false if the data does not match
+    bool appendSamples(Curve &c);
+    void updateZoomBase();
+
+    std::vector<Curve> curves;
+    std::unique_ptr<SeriesDataBuilder> lodBuilder; // builds the level of detail data of all curves
     QwtPlot *plot{nullptr};
     QVector<QPen> pen;
     QwtPlotZoomer *zoom{nullptr};
     double xMinValue{0}, yMinValue{0}, xMaxValue{0}, yMaxValue{0};
     bool plotGrid{true};
+
+  Q_SIGNALS:
+    //! emitted (by the thread of lodBuilder) when the level of detail data of the visible samples is built
+    void lodBuiltSignal();
 };
 
 #endif // PLOTAREA_H
@@ -0,0 +1,248 @@
+/*
+    h5plotserie - plot the data of a hdf5 file.
+    Copyright (C) 2010 Markus Schneider
+
+  This library is free software; you can redistribute it and/or 
+  modify it under the terms of the GNU Lesser General Public 
+  License as published by the Free Software Foundation; either 
+  version 2.1 of the License, or (at your option) any later version. 
+   
+  This library is distributed in the hope that it will be useful, 
+  but WITHOUT ANY WARRANTY; without even the implied warranty of 
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU 
+  Lesser General Public License for more details. 
+   
+  You should have received a copy of the GNU Lesser General Public 
+  License along with this library; if not, write to the Free Software 
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+*/
+
+#include <config.h>
+#include "seriesdata.h"
+#include <cmath>
+#include <algorithm>
+
+SeriesDataBuilder::SeriesDataBuilder() {
+  thread=std::thread(&SeriesDataBuilder::run, this);
+}
+
+SeriesDataBuilder::~SeriesDataBuilder() {
+  {
+    std::scoped_lock lock(mutex);
+    exit=true;
+  }
+  cond.notify_all();
+  thread.join();
+}
+
+void SeriesDataBuilder::add(SeriesData *data) {
+  std::scoped_lock lock(mutex);
+  series.push_back(data);
+}
+
+void SeriesDataBuilder::remove(SeriesData *data) {
+  std::unique_lock lock(mutex);
+  series.erase(std::find(series.begin(), series.end(), data));
+  cond.wait(lock, [this, data](){ return building!=data; });
+}
+
+void SeriesDataBuilder::notify() {
+  {
+    std::scoped_lock lock(mutex);
+    pending=true;
+  }
+  cond.notify_all();
+}
+
+void SeriesDataBuilder::run() {
+  std::unique_lock lock(mutex);
+  while(true) {
+    cond.wait(lock, [this](){ return exit || pending; });
+    if(exit)
+      return;
+    pending=false;
+    // a chunk of each SeriesData in turn until all pyramids are built
+    bool built=true;
+    while(built && !exit) {
+      built=false;
+      for(size_t i=0; i<series.size() && !exit; ++i) {
+        building=series[i];
+        lock.unlock();
+        built|=building->build();
+        lock.lock();
+        building=nullptr;
+        cond.notify_all(); // remove may wait for this SeriesData
+      }
+    }
+  }
+}
+
+SeriesData::SeriesData(SeriesDataBuilder &builder_) : builder(builder_) {
+  builder.add(this);
+}
+
+SeriesData::~SeriesData() {
+  builder.remove(this);
+}
+
+QRectF SeriesData::boundingRect() const {
+  if(xMin>xMax || yMin>yMax)
+    return QRectF(1.0, 1.0, -2.0, -2.0); // invalid rect (the same as Qwt uses for no samples)
+  return QRectF(xMin, yMin, xMax-xMin, yMax-yMin);
+}
+
+void SeriesData::append(const double *xNew, const double *yNew, size_t n) {
+  {
+    std::scoped_lock lock(mutex); // the background thread reads x and y
+    x.insert(x.end(), xNew, xNew+n);
+    y.insert(y.end(), yNew, yNew+n);
+  }
+  builder.notify();
+  for(size_t i=0; i<n; ++i) {
+    if(!std::isnan(xNew[i])) {
+      xMin=std::min(xMin, xNew[i]);
+      xMax=std::max(xMax, xNew[i]);
+    }
+    if(!std::isnan(yNew[i])) {
+      yMin=std::min(yMin, yNew[i]);
+      yMax=std::max(yMax, yNew[i]);
+    }
+  }
+  for(size_t i=x.size()-n; i<x.size() && monotonic; ++i)
+    if(i>0 && !(x[i]>=x[i-1]))
+      monotonic=false;
+  updateVisible();
+}
+
+void SeriesData::setBuiltCallback(std::function<void()> builtCallback_) {
+  std::scoped_lock lock(callbackMutex); // waits for a running callback
+  builtCallback=std::move(builtCallback_);
+}
+
+void SeriesData::setPixels(int pixels_) {
+  pixels_=std::max(pixels_, 1);
+  if(pixels==pixels_)
+    return;
+  pixels=pixels_;
+  updateVisible();
+}
+
+void SeriesData::setRectOfInterest(const QRectF &rect) {
+  rectOfInterest=rect;
+  haveRectOfInterest=true;
+  updateVisible();
+}
+
+bool SeriesData::build() {
+  std::unique_lock lock(mutex);
+  if(levels.empty() ? x.size()<factor : x.size()/factor<=levels[0].size())
+    return false;
+  if(levels.empty())
+    levels.emplace_back();
+
+  // level 0 from the samples: a chunk at once, than the lock is released to let the GUI thread append samples
+  size_t end=std::min(x.size()/factor, levels[0].size()+(1<<14))*factor;
+  for(size_t b=levels[0].size()*factor; b<end; b+=factor) {
+    Bucket bucket{b, b};
+    for(size_t i=b+1; i<b+factor; ++i) {
+      if(y[i]<y[bucket.iMin]) bucket.iMin=i;
+      if(y[i]>y[bucket.iMax]) bucket.iMax=i;
+    }
+    levels[0].push_back(bucket);
+  }
+  // all other levels from the level below
+  for(size_t l=1; levels[l-1].size()>=factor; ++l) {
+    if(levels.size()<=l)
+      levels.emplace_back();
+    auto &lower=levels[l-1];
+    for(size_t b=levels[l].size()*factor; b+factor<=lower.size(); b+=factor) {
+      Bucket bucket=lower[b];
+      for(size_t i=b+1; i<b+factor; ++i) {
+        if(y[lower[i].iMin]<y[bucket.iMin]) bucket.iMin=lower[i].iMin;
+        if(y[lower[i].iMax]>y[bucket.iMax]) bucket.iMax=lower[i].iMax;
+      }
+      levels[l].push_back(bucket);
+    }
+  }
+
+  bool done=x.size()/factor==levels[0].size();
+  bool callCallback=done && needReplot;
+  if(callCallback)
+    needReplot=false;
+  lock.unlock();
+  if(callCallback) {
+    std::scoped_lock callbackLock(callbackMutex);
+    if(builtCallback)
+      builtCallback();
+  }
+  return true;
+}
+
+void SeriesData::appendMinMax(size_t begin, size_t end) {
+  if(begin>=end)
+    return;
+  Bucket b{begin, begin};
+  for(size_t i=begin+1; i<end; ++i) {
+    if(y[i]<y[b.iMin]) b.iMin=i;
+    if(y[i]>y[b.iMax]) b.iMax=i;
+  }
+  appendMinMax(b);
+}
+
+void SeriesData::appendMinMax(const Bucket &b) {
+  visible.push_back(std::min(b.iMin, b.iMax));
+  visible.push_back(std::max(b.iMin, b.iMax));
+}
+
+void SeriesData::updateVisible() {
+  size_t n=x.size();
+  decimated=false;
+  first=0;
+  count=n;
+  if(!haveRectOfInterest || !monotonic || !(rectOfInterest.width()>0))
+    return;
+
+  // the visible range [i0, i1) including one sample left and right of the rect (for the lines to the border)
+  auto it0=std::lower_bound(x.begin(), x.end(), rectOfInterest.left());
+  auto it1=std::upper_bound(x.begin(), x.end(), rectOfInterest.right());
+  size_t i0=std::max<size_t>(it0-x.begin(), 1)-1;
+  size_t i1=std::min<size_t>(it1-x.begin()+1, n);
+  if(i0>=i1) {
+    count=0;
+    return;
+  }
+  if(i1-i0<=2*static_cast<size_t>(pixels)) {
+    first=i0;
+    count=i1-i0;
+    return;
+  }
+
+  // the level with at most one bucket per pixel
+  size_t level=0;
+  size_t s=factor;
+  while((i1-i0)/s>static_cast<size_t>(pixels)) {
+    ++level;
+    s*=factor;
+  }
+
+  std::scoped_lock lock(mutex); // the background thread writes the pyramid
+  decimated=true;
+  visible.clear();
+  visible.push_back(i0);
+  size_t b0=(i0+s-1)/s; // the first full bucket
+  size_t b1=i1/s; // the end of the full buckets
+  appendMinMax(i0+1, std::min(b0*s, i1));
+  size_t built=level<levels.size() ? levels[level].size() : 0;
+  for(size_t b=b0; b<b1; ++b) {
+    if(b<built)
+      appendMinMax(levels[level][b]);
+    else {
+      // not built yet: two samples of the bucket (until the background thread has built it)
+      visible.push_back(b*s);
+      visible.push_back(b*s+s/2);
+      needReplot=true;
+    }
+  }
+  appendMinMax(std::max(b1*s, b0*s), i1-1);
+  visible.push_back(i1-1);
+}
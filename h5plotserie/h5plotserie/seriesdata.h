@@ -0,0 +1,147 @@
+/*
+    h5plotserie - plot the data of a hdf5 file.
+    Copyright (C) 2010 Markus Schneider
+
+  This library is free software; you can redistribute it and/or 
+  modify it under the terms of the GNU Lesser General Public 
+  License as published by the Free Software Foundation; either 
+  version 2.1 of the License, or (at your option) any later version. 
+   
+  This library is distributed in the hope that it will be useful, 
+  but WITHOUT ANY WARRANTY; without even the implied warranty of 
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU 
+  Lesser General Public License for more details. 
+   
+  You should have received a copy of the GNU Lesser General Public 
+  License along with this library; if not, write to the Free Software 
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+*/
+
+#ifndef SERIESDATA_H
+#define SERIESDATA_H
+
+#if __GNUC__ >= 14
+  // qwt it not (yet) gcc >= 14 save
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wtemplate-id-cdtor"
+#endif
+#include <qwt_series_data.h>
+#if __GNUC__ >= 14
+  #pragma GCC diagnostic pop
+#endif
+#include <vector>
+#include <limits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+class SeriesData;
+
+/** The background thread building the min/max pyramids of all SeriesData of a plot.
+ *
+ * A SeriesData registers itself at construction and unregisters at destruction. The pyramids are built in chunks
+ * round robin over all registered SeriesData. The thread is joined by the destructor: all SeriesData using this
+ * builder must be destroyed before it. */
+class SeriesDataBuilder {
+
+  public:
+    SeriesDataBuilder();
+    ~SeriesDataBuilder();
+
+  private:
+    friend class SeriesData;
+
+    void add(SeriesData *data);
+    //! remove data; waits until the thread does not build data anymore
+    void remove(SeriesData *data);
+    //! wake up the thread (new samples were appended)
+    void notify();
+    void run();
+
+    std::mutex mutex; // guards all members except thread
+    std::condition_variable cond;
+    std::vector<SeriesData*> series;
+    SeriesData *building{nullptr}; // the SeriesData currently built by the thread (without holding mutex)
+    bool pending{false}; // samples were appended since the thread has checked all SeriesData
+    bool exit{false};
+    std::thread thread;
+};
+
+/** The samples of a curve which can grow.
+ *
+ * New samples are appended (e.g. after a refresh of a file written by another process) and the bounding rect
+ * is updated using the new samples only. NaN values are ignored for the bounding rect.
+ *
+ * Level of detail: the background thread of a SeriesDataBuilder builds a min/max pyramid of the samples (level l holds
+ * the index of the min and max y value of each bucket of 4^(l+1) samples) and extends it when samples are appended.
+ * Qwt passes the visible area by setRectOfInterest; if x is monotonic only about 2 samples per pixel (the min and
+ * max of the visible buckets) are passed to Qwt. Samples not yet in the pyramid are shown decimated (each bucket by
+ * two samples) until the pyramid is built; then builtCallback is called (from the background thread) to request a replot. */
+class SeriesData : public QwtSeriesData<QPointF> {
+
+  public:
+    SeriesData(SeriesDataBuilder &builder_);
+    ~SeriesData() override;
+
+    size_t size() const override { return decimated ? visible.size() : count; }
+    QPointF sample(size_t i) const override {
+      size_t idx=decimated ? visible[i] : first+i;
+      return {x[idx], y[idx]};
+    }
+    QRectF boundingRect() const override;
+    void setRectOfInterest(const QRectF &rect) override;
+
+    //! the number of all samples (not only the visible ones)
+    size_t rawSize() const { return x.size(); }
+
+    //! append n samples
+    void append(const double *xNew, const double *yNew, size_t n);
+
+    //! set the width of the plot canvas in pixel (call it when the canvas is resized)
+    void setPixels(int pixels_);
+
+    //! set the function which is called (from the background thread) when the pyramid of the displayed data is built.
+    //! When this function returns the old function is no longer running and will not be called anymore
+    //! (set an empty function before the object captured by the callback is destroyed).
+    void setBuiltCallback(std::function<void()> builtCallback_);
+
+  private:
+    friend class SeriesDataBuilder;
+
+    static constexpr size_t factor=4; // number of buckets of a level combined by the next level
+
+    struct Bucket {
+      size_t iMin, iMax; // index of the min and max y value in the bucket
+    };
+
+    //! build the next chunk of the pyramid (called by the thread of builder); returns false if there was nothing to build
+    bool build();
+    //! append the indices of the min and max y value of the samples [begin, end) to visible (in index order)
+    void appendMinMax(size_t begin, size_t end);
+    void appendMinMax(const Bucket &b);
+    void updateVisible();
+
+    SeriesDataBuilder &builder;
+    std::vector<double> x, y;
+    double xMin{std::numeric_limits<double>::max()}, xMax{std::numeric_limits<double>::lowest()};
+    double yMin{std::numeric_limits<double>::max()}, yMax{std::numeric_limits<double>::lowest()};
+    bool monotonic{true}; // x is monotonic increasing: only then the visible samples can be found by x
+
+    // the visible samples: [first, first+count) if not decimated, else the indices in visible
+    bool decimated{false};
+    size_t first{0}, count{0};
+    std::vector<size_t> visible;
+    QRectF rectOfInterest;
+    bool haveRectOfInterest{false};
+    int pixels{2000};
+
+    // the pyramid (written by the thread of builder, guarded by mutex; x and y are only read by this thread)
+    std::vector<std::vector<Bucket>> levels;
+    std::mutex mutex;
+    bool needReplot{false}; // the visible samples contain samples not yet in the pyramid
+    std::mutex callbackMutex; // guards builtCallback and is held while it is called
+    std::function<void()> builtCallback;
+};
+
+#endif // SERIESDATA_H
@@ -0,0 +1,96 @@
+/* Copyright (C) 2009 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+
+// Benchmark of the compression filters of VectorSerie (write/read speed and compression ratio).
+// Not part of the tests, build it using "make benchfilter".
+
+#include <config.h>
+#include <hdf5serie/vectorserie.h>
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+using namespace H5;
+using namespace std;
+
+int main() {
+  // a typical simulation result: time, smooth positions and velocities of some bodies and a few discrete signals
+  const size_t rows=100000;
+  const size_t cols=40;
+  vector<double> data(rows*cols);
+  for(size_t r=0; r<rows; ++r) {
+    double t=r*1e-3;
+    data[r*cols]=t;
+    for(size_t c=1; c<cols; ++c) {
+      if(c%10==0)
+        data[r*cols+c]=floor(t*c/10); // a step signal
+      else
+        data[r*cols+c]=sin(t*c*0.7+c)*c+cos(t*3.1/c)*1e-3; // a smooth signal
+    }
+  }
+  double mb=static_cast<double>(rows*cols*sizeof(double))/1024/1024;
+
+  struct Case {
+    string name;
+    Options opts;
+  };
+  vector<Case> cases {
+    { "none",                Options{}._compression(0) },
+    { "deflate 1",           Options{}._compression(1) },
+    { "deflate 1 (direct)",  Options{}._compression(1)._directChunkWrite(true) },
+    { "shuffle+deflate 1",   Options{}._compression(1)._filter(Filter::shuffleDeflate) },
+    { "bitshuffle+deflate 1",Options{}._compression(1)._filter(Filter::bitshuffleDeflate) },
+    { "bitshuffle+deflate 1 (direct)", Options{}._compression(1)._filter(Filter::bitshuffleDeflate)._directChunkWrite(true) },
+    { "shuffle+lz4",         Options{}._compression(1)._filter(Filter::shuffleLZ4) },
+    { "shuffle+zstd 3",      Options{}._compression(3)._filter(Filter::shuffleZstd) },
+  };
+
+  cout<<left<<setw(32)<<"filter"<<right<<setw(14)<<"write [MB/s]"<<setw(14)<<"read [MB/s]"<<setw(10)<<"ratio"<<endl;
+  for(auto &c : cases) {
+    const char *filename="benchfilter.h5";
+    auto start=chrono::steady_clock::now();
+    {
+      File file(filename, File::write);
+      auto *ts=file.createChildObject<VectorSerie<double> >("data")(cols, c.opts._chunkSize(1000)._cacheSize(1000));
+      for(size_t r=0; r<rows; ++r)
+        ts->append(&data[r*cols], cols);
+    }
+    double writeTime=chrono::duration<double>(chrono::steady_clock::now()-start).count();
+    auto size=boost::filesystem::file_size(filename);
+
+    start=chrono::steady_clock::now();
+    {
+      File file(filename, File::read);
+      auto *ts=file.openChildObject<VectorSerie<double> >("data");
+      for(size_t c=0; c<cols; ++c)
+        ts->getColumn(c);
+    }
+    double readTime=chrono::duration<double>(chrono::steady_clock::now()-start).count();
+
+    cout<<left<<setw(32)<<c.name<<right<<fixed<<setprecision(1)<<setw(14)<<mb/writeTime<<setw(14)<<mb/readTime
+        <<setw(10)<<static_cast<double>(rows*cols*sizeof(double))/size<<endl;
+    boost::filesystem::remove(filename);
+  }
+  return 0;
+}
@@ -27,11 +27,16 @@
 #  define __STRICT_ANSI__
 #endif
 #include <config.h>
+#include <algorithm>
 #include <cassert>
 #include <cfenv>
+#include <cstdlib>
+#include <functional>
 #include <hdf5serie/vectorserie.h>
 #include <hdf5serie/simpleattribute.h>
 #include <hdf5serie/simpledataset.h>
+#include <hdf5serie/filter.h>
+#include <hdf5serie/group.h>
 #include <iostream>
 #include <fmatvec/fmatvec.h>
 #include <boost/filesystem.hpp>
@@ -50,6 +55,8 @@ namespace bfs = boost::filesystem;
 //};
 
 int worker(File::FileAccess writeType, bool callEnableSWMR);
+int summaryReader();
+string testlibExe; // argv[0]: used to run this program as a SWMR reader process
 
 template<class T1, class T2>
 int checkConversion() {
@@ -85,7 +92,71 @@ int checkConversion() {
   }
 }
 
-int main() {
+// check the number of rows of ts and each element (row r, column c) against expected(r, c)
+int checkContent(VectorSerie<double> *ts, int rows, const function<double(int, int)> &expected) {
+  if(ts->getRows()!=rows) {
+    cerr<<"Wrong h5 file content: "<<ts->getPath()<<" has "<<ts->getRows()<<" rows instead of "<<rows<<endl;
+    return 1;
+  }
+  for(int r=0; r<rows; ++r) {
+    auto row=ts->getRow(r);
+    for(int c=0; c<static_cast<int>(row.size()); ++c)
+      if(row[c]!=expected(r, c)) {
+        cerr<<"Wrong h5 file content: "<<ts->getPath()<<" row "<<r<<" column "<<c<<" is "<<row[c]<<" instead of "<<expected(r, c)<<endl;
+        return 1;
+      }
+  }
+  return 0;
+}
+
+// the SWMR reader process of the summary written by worker
+int summaryReader() {
+  File file("testswmr.h5", File::read);
+  auto *ts=file.openChildObject<VectorSerie<double> >("summary");
+  vector<double> min, max, mean;
+  ts->getSummary(1, 1, min, max, mean); // blocks of 8 rows: 4 complete blocks (read from level 1) and the remaining 5 rows
+  if(ts->getRows()!=37 || min.size()!=5 || min[0]!=-7 || max[0]!=0 || mean[3]!=-27.5 || min[4]!=-36) {
+    cerr<<"Wrong summary content"<<endl;
+    return 1;
+  }
+  return 0;
+}
+
+// check Internal::bitshuffle against the format of the bitshuffle filter: bit j of element e of a block of m elements
+// is stored at bit j*m+e of the block. Blocks have 8192/typeSize elements (rounded down to a multiple of 8), the remaining
+// elements form a last block rounded down to a multiple of 8 and the elements after it are copied.
+int checkBitshuffle(size_t n, size_t typeSize) {
+  vector<unsigned char> in(n*typeSize), out(n*typeSize), ref(n*typeSize, 0), back(n*typeSize);
+  for(size_t i=0; i<in.size(); ++i)
+    in[i]=static_cast<unsigned char>(i*2654435761u>>13);
+  size_t blockSize=8192/typeSize/8*8;
+  for(size_t first=0; first<n; first+=blockSize) {
+    size_t m=min(blockSize, n-first);
+    if(m<blockSize)
+      m=m/8*8;
+    for(size_t e=0; e<m; ++e)
+      for(size_t j=0; j<8*typeSize; ++j)
+        if((in[(first+e)*typeSize+j/8]>>(j%8)) & 1)
+          ref[first*typeSize+(j*m+e)/8]|=1<<((j*m+e)%8);
+    if(m<blockSize) {
+      copy(in.begin()+(first+m)*typeSize, in.end(), ref.begin()+(first+m)*typeSize);
+      break;
+    }
+  }
+  Internal::bitshuffle(in.data(), out.data(), n, typeSize);
+  Internal::bitunshuffle(out.data(), back.data(), n, typeSize);
+  if(out!=ref || back!=in) {
+    cerr<<"Wrong bitshuffle"<<endl;
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  testlibExe=argv[0];
+  if(argc==2 && argv[1]==string("summaryreader"))
+    return summaryReader();
+
 #ifdef _WIN32
   SetConsoleCP(CP_UTF8);
   SetConsoleOutputCP(CP_UTF8);
@@ -104,6 +175,8 @@ int main() {
   ret += checkConversion<double, float>();
   ret += checkConversion<int, long>();
   ret += checkConversion<long, int>();
+  ret += checkBitshuffle(3003, 8);
+  ret += checkBitshuffle(2070, 4);
 
   return ret;
 }
@@ -204,6 +277,10 @@ int worker(File::FileAccess writeType, bool callEnableSWMR) {
   dout=dsd->read();
   for(double d : dout) cout<<d<<endl;
   cout<<dsd->getDescription()<<endl;
+  if(dsd->read(1, 1)!=vector<double>{7.34}) {
+    cerr<<"Wrong partial read"<<endl;
+    return 1;
+  }
   }
   
 
@@ -543,6 +620,392 @@ int worker(File::FileAccess writeType, bool callEnableSWMR) {
     return 1;
   }
   }
+  {
+  File::setDefaultCacheSize(6);
+  File::setDefaultAsyncWrite(true);
+  write("test2dasync.h5");
+  File::setDefaultAsyncWrite(false);
+  File::setDefaultCacheSize(0);
+  }
+  {
+  File file("test2dasync.h5", File::read);
+  auto *ts=file.openChildObject<VectorSerie<double> >("timeserie");
+  if(ts->getRows()!=15) {
+    cerr<<"Wrong h5 file content"<<endl;
+    return 1;
+  }
+  auto row=ts->getRow(14);
+  if(row[0]!=1.2+14 || row[1]!=2.3+14 || row[2]!=3.4+14) {
+    cerr<<"Wrong h5 file content"<<endl;
+    return 1;
+  }
+  auto *tsFixedStr=file.openChildObject<VectorSerie<string> >("timeserieFixedStr");
+  if(tsFixedStr->getRow(0)[2]!="ccc" || tsFixedStr->getColumns({2, 1})[1][0]!="bb") {
+    cerr<<"Wrong h5 file content"<<endl;
+    return 1;
+  }
+  }
+  // rows 1 to 11 of a dataset with the columns i and 2*i
+  boost::multi_array<double, 2> rows(boost::extents[11][2]);
+  for(int i=0; i<11; ++i) {
+    rows[i][0]=i+1;
+    rows[i][1]=2*(i+1);
+  }
+  {
+  // appendSlot with async write and appendRows of a partial cache block followed by bulk rows
+  File file("testappend.h5", writeType);
+  auto *ts=file.createChildObject<VectorSerie<double> >("slot")(2, Options{}._cacheSize(4)._asyncWrite(true)._cacheBlocks(3));
+  for(int i=0; i<10; ++i) {
+    double *row=ts->appendSlot();
+    row[0]=i;
+    row[1]=2*i;
+  }
+  auto *bulk=file.createChildObject<VectorSerie<double> >("bulk")(2, Options{}._cacheSize(4));
+  bulk->append(vector<double>{0, 0});
+  bulk->appendRows(rows);
+  }
+  {
+  File file("testappend.h5", File::read);
+  if(checkContent(file.openChildObject<VectorSerie<double> >("slot"), 10, [](int r, int c) { return (c+1.0)*r; }))
+    return 1;
+  auto *bulk=file.openChildObject<VectorSerie<double> >("bulk");
+  if(checkContent(bulk, 12, [](int r, int c) { return (c+1.0)*r; }))
+    return 1;
+  vector<double> tail(3*2);
+  bulk->getRows(9, 3, 2, tail.data()); // the last 3 rows
+  auto decimated=bulk->getColumn(1, 1, 5); // rows 1, 6, 11
+  if(tail[0]!=9 || tail[5]!=22 || decimated.size()!=3 || decimated[0]!=2 || decimated[1]!=12 || decimated[2]!=22) {
+    cerr<<"Wrong rows read in blocks"<<endl;
+    return 1;
+  }
+  size_t lastSeen=10;
+  vector<double> newRows;
+  size_t lastSeenCols=0;
+  vector<vector<double>> newCols;
+  if(bulk->getRowsSince(lastSeen, newRows)!=2 || lastSeen!=12 || newRows.size()!=4 || newRows[3]!=22 ||
+     bulk->getRowsSince(lastSeen, newRows)!=0 || newRows.size()!=4 ||
+     bulk->getColumnsSince({1}, lastSeenCols, newCols)!=12 || newCols[0][11]!=22) {
+    cerr<<"Wrong new rows"<<endl;
+    return 1;
+  }
+  for(bool prefetch : {false, true}) {
+    size_t nr=0;
+    auto range=bulk->getRowRange(1, 100, 5, prefetch); // blocks [1,5[, [5,10[, [10,12[
+    for(auto it=range.begin(); it!=range.end(); ++it, ++nr)
+      if((*it)[1]!=2.0*it.getRow()) {
+        cerr<<"Wrong row range"<<endl;
+        return 1;
+      }
+    if(nr!=11) {
+      cerr<<"Wrong row range"<<endl;
+      return 1;
+    }
+  }
+  // only the subscribed datasets are refreshed now; subscriptions are counted
+  file.subscribe(bulk);
+  file.subscribe(bulk);
+  file.refresh();
+  file.unsubscribe(bulk);
+  file.unsubscribe(bulk);
+  try {
+    file.unsubscribe(bulk);
+    cerr<<"Wrong subscription"<<endl;
+    return 1;
+  }
+  catch(const Exception &) {
+  }
+  }
+  {
+  // reserveExtent: the writer sees only the written rows and the reserved extent is trimmed on close
+  File file("testreserve.h5", writeType);
+  auto *reserve=file.createChildObject<VectorSerie<double> >("reserve")(1, Options{}._cacheSize(4)._reserveExtent(true));
+  for(int i=0; i<13; ++i)
+    reserve->append(vector<double>{static_cast<double>(i)});
+  if(reserve->getRows()!=12) {
+    cerr<<"Wrong number of rows with reserved extent"<<endl;
+    return 1;
+  }
+  }
+  {
+  File file("testreserve.h5", File::read);
+  if(checkContent(file.openChildObject<VectorSerie<double> >("reserve"), 13, [](int r, int) { return r; }))
+    return 1;
+  }
+  {
+  // directChunkWrite of single rows followed by bulk rows, synchronous and async
+  File file("testdirect.h5", writeType);
+  for(bool asyncWrite : {false, true}) {
+    auto *direct=file.createChildObject<VectorSerie<double> >(string("direct")+(asyncWrite ? "Async" : ""))(
+      2, Options{}._chunkSize(4)._directChunkWrite(true)._asyncWrite(asyncWrite));
+    for(int i=0; i<3; ++i)
+      direct->append(vector<double>{static_cast<double>(i), 2.0*i});
+    direct->appendRows(rows); // rows 3 to 13
+  }
+  }
+  {
+  File file("testdirect.h5", File::read);
+  for(auto &name : {"direct", "directAsync"})
+    if(checkContent(file.openChildObject<VectorSerie<double> >(name), 14, [](int r, int c) { return (c+1.0)*(r<3 ? r : r-2); }))
+      return 1;
+  }
+  {
+  // chunks of 1 or 2 columns
+  File file("testcolumns.h5", writeType);
+  for(int chunkColumns : {1, 2})
+    for(bool directChunkWrite : {false, true}) {
+      auto *ts=file.createChildObject<VectorSerie<double> >("columns"+to_string(chunkColumns)+(directChunkWrite ? "direct" : ""))(
+        3, Options{}._chunkSize(4)._chunkColumns(chunkColumns)._directChunkWrite(directChunkWrite));
+      for(int i=0; i<10; ++i)
+        ts->append(vector<double>{static_cast<double>(i), 2.0*i, 3.0*i});
+    }
+  }
+  {
+  File file("testcolumns.h5", File::read);
+  for(int chunkColumns : {1, 2})
+    for(auto &direct : {"", "direct"}) {
+      auto *ts=file.openChildObject<VectorSerie<double> >("columns"+to_string(chunkColumns)+direct);
+      if(checkContent(ts, 10, [](int r, int c) { return (c+1.0)*r; }))
+        return 1;
+      auto col=ts->getColumn(2);
+      if(col.size()!=10 || col[9]!=27) {
+        cerr<<"Wrong column"<<endl;
+        return 1;
+      }
+    }
+  auto *ts=file.openChildObject<VectorSerie<double> >("columns2");
+  auto cols=ts->getColumns({2, 0, 2});
+  vector<double> part(2*3);
+  ts->getColumns({1, 2}, 5, 3, part.data()); // rows 5 to 7
+  if(cols.size()!=3 || cols[0].size()!=10 || cols[0][9]!=27 || cols[1][9]!=9 || cols[2][4]!=12 ||
+     part[0]!=10 || part[2]!=14 || part[3]!=15 || part[5]!=21) {
+    cerr<<"Wrong columns"<<endl;
+    return 1;
+  }
+  }
+  {
+  // shuffle and bitshuffle filters
+  File file("testfilter.h5", writeType);
+  for(auto filter : {Filter::shuffleDeflate, Filter::bitshuffleDeflate})
+    for(bool directChunkWrite : {false, true}) {
+      auto *ts=file.createChildObject<VectorSerie<double> >("filter"+to_string(static_cast<int>(filter))+(directChunkWrite ? "direct" : ""))(
+        2, Options{}._chunkSize(4)._filter(filter)._directChunkWrite(directChunkWrite));
+      ts->appendRows(rows);
+    }
+  }
+  {
+  File file("testfilter.h5", File::read);
+  for(auto filter : {Filter::shuffleDeflate, Filter::bitshuffleDeflate})
+    for(auto &direct : {"", "direct"}) {
+      auto *ts=file.openChildObject<VectorSerie<double> >("filter"+to_string(static_cast<int>(filter))+direct);
+      if(checkContent(ts, 11, [](int r, int c) { return (c+1.0)*(r+1); }))
+        return 1;
+      if(filter==Filter::bitshuffleDeflate) {
+        // the registered bitshuffle filter with the cd_values of the bitshuffle plugin (no compression of its own)
+        ScopedHID cpl(H5Dget_create_plist(ts->getID()), &H5Pclose);
+        unsigned int flags;
+        size_t nelmts=5;
+        unsigned int values[5];
+        if(H5Pget_filter_by_id2(cpl, 32008, &flags, &nelmts, values, 0, nullptr, nullptr)<0 || nelmts!=5 ||
+           values[2]!=sizeof(double) || values[3]!=0 || values[4]!=0) {
+          cerr<<"Wrong bitshuffle filter"<<endl;
+          return 1;
+        }
+      }
+    }
+  }
+  {
+  // mapped chunks of an uncompressed aligned dataset and the chunk cache
+  File file("testmap.h5", writeType);
+  auto *ts=file.createChildObject<VectorSerie<double> >("uncompressed")(3, Options{}._chunkSize(4)._compression(0)._alignChunks(true));
+  for(int i=0; i<10; ++i)
+    ts->append(vector<double>{static_cast<double>(i), 2.0*i, 3.0*i});
+  auto *filtered=file.createChildObject<VectorSerie<double> >("filtered")(2, Options{}._chunkSize(4)._filter(Filter::shuffleDeflate));
+  filtered->appendRows(rows);
+  }
+  {
+  File file("testmap.h5", File::read);
+  auto *ts=file.openChildObject<VectorSerie<double> >("uncompressed");
+  VectorSerie<double>::MappedChunk chunk;
+  auto row=ts->mapRow(9);
+  if(!ts->mapChunk(9, 2, chunk) || chunk.firstRow!=8 || chunk.nrRows!=2 || chunk.nrColumns!=3 || chunk(9, 2)!=27 ||
+     !row || row[1]!=18 || file.openChildObject<VectorSerie<double> >("filtered")->mapRow(9)) {
+    cerr<<"Wrong mapped chunk"<<endl;
+    return 1;
+  }
+  // the chunk cache is disabled by default: getRow reads single rows
+  if(checkContent(ts, 10, [](int r, int c) { return (c+1.0)*r; }))
+    return 1;
+  if(file.getChunkCacheStats().misses!=0 || file.getChunkCacheStats().hits!=0 || file.getChunkCacheStats().size!=0) {
+    cerr<<"Wrong chunk cache statistics"<<endl;
+    return 1;
+  }
+  file.setChunkCacheBudget(1024*1024);
+  auto stats=file.getChunkCacheStats();
+  if(checkContent(ts, 10, [](int r, int c) { return (c+1.0)*r; }))
+    return 1;
+  // 3 chunk rows of 4 rows: 3 misses and 7 hits
+  if(file.getChunkCacheStats().misses-stats.misses!=3 || file.getChunkCacheStats().hits-stats.hits!=7) {
+    cerr<<"Wrong chunk cache statistics"<<endl;
+    return 1;
+  }
+  }
+  {
+  // summary levels written with and without directChunkWrite
+  File file("testsummary.h5", writeType);
+  for(bool directChunkWrite : {false, true}) {
+    auto *ts=file.createChildObject<VectorSerie<double> >(string("summary")+(directChunkWrite ? "direct" : ""))(
+      2, Options{}._chunkSize(4)._directChunkWrite(directChunkWrite)._summaryLevels(3)._summaryBlockRows(4));
+    for(int i=0; i<37; ++i)
+      ts->append(vector<double>{static_cast<double>(i), -1.0*i});
+  }
+  }
+  {
+  File file("testsummary.h5", File::read);
+  for(auto &name : {"summary", "summarydirect"}) {
+    auto *ts=file.openChildObject<VectorSerie<double> >(name);
+    vector<double> min, max, mean;
+    ts->getSummary(1, 1, min, max, mean); // blocks of 8 rows: 4 complete blocks and the remaining 5 rows
+    if(ts->getSummaryLevels()!=3 || ts->getSummaryBlockRows()!=4 || min.size()!=5 ||
+       min[0]!=-7 || max[0]!=0 || mean[0]!=-3.5 || min[4]!=-36 || max[4]!=-32 || mean[4]!=-34) {
+      cerr<<"Wrong summary content"<<endl;
+      return 1;
+    }
+  }
+  // the summary groups are listed and opened like any other group
+  auto names=file.getChildObjectNames();
+  if(find(names.begin(), names.end(), string("summary")+summaryGroupSuffix)==names.end() ||
+     file.openChildObject<Group>(string("summary")+summaryGroupSuffix)->getChildObjectNames().size()!=3) {
+    cerr<<"Wrong summary group"<<endl;
+    return 1;
+  }
+  }
+  {
+  // auto-flush by a row budget
+  File file("testautoflush.h5", writeType);
+  auto *other=file.createChildObject<VectorSerie<double> >("other")(1, Options{}._cacheSize(100));
+  other->append(vector<double>{0});
+  auto *autoFlush=file.createChildObject<VectorSerie<double> >("autoflush")(1, Options{}._cacheSize(100));
+  if(callEnableSWMR) {
+    file.enableSWMR();
+    file.setAutoFlush(0ms, 4);
+  }
+  for(int i=0; i<6; ++i)
+    autoFlush->append(vector<double>{static_cast<double>(i)});
+  // the row budget of 4 has flushed the first 4 rows, the remaining rows are still in the cache (only this dataset is dirty)
+  if(callEnableSWMR && (autoFlush->getExtentDims()[0]!=4 || !autoFlush->isDirty() || other->isDirty())) {
+    cerr<<"Wrong auto-flush"<<endl;
+    return 1;
+  }
+  }
+  {
+  File file("testautoflush.h5", File::read);
+  if(checkContent(file.openChildObject<VectorSerie<double> >("autoflush"), 6, [](int r, int) { return r; }))
+    return 1;
+  }
+  {
+  // datasets flushed by a full flush are listed only once as modified datasets of the file
+  File file("testdirty.h5", writeType);
+  auto *ts1=file.createChildObject<VectorSerie<double> >("ts1")(1);
+  auto *ts2=file.createChildObject<VectorSerie<double> >("ts2")(1);
+  for(int i=0; i<10; ++i) {
+    ts1->append(vector<double>{static_cast<double>(i)});
+    ts2->append(vector<double>{static_cast<double>(i)});
+    file.flush();
+  }
+  if(file.getDirtyDatasetCount()!=2) {
+    cerr<<"Wrong number of dirty datasets"<<endl;
+    return 1;
+  }
+  }
+  for(int compression : {0, 9}) {
+    {
+    // flush a partial chunk and fill it while the writer thread (and the compression pool for compression>0) writes it
+    File file("testflush.h5", writeType);
+    auto *ts=file.createChildObject<VectorSerie<double> >("directAsyncFlush")(
+      2, Options{}._chunkSize(4)._directChunkWrite(true)._asyncWrite(true)._compression(compression));
+    for(int i=0; i<3; ++i)
+      ts->append(vector<double>{static_cast<double>(i), 2.0*i});
+    file.flush();
+    for(int i=3; i<6; ++i)
+      ts->append(vector<double>{static_cast<double>(i), 2.0*i});
+    }
+    File file("testflush.h5", File::read);
+    auto *ts=file.openChildObject<VectorSerie<double> >("directAsyncFlush");
+    if(checkContent(ts, 6, [](int r, int c) { return (c+1.0)*r; }))
+      return 1;
+    // directChunkWrite aligns the chunks: uncompressed chunks can be mapped
+    auto row=ts->mapRow(5);
+    if(compression==0 && (!row || row[1]!=10)) {
+      cerr<<"Wrong mapped chunk"<<endl;
+      return 1;
+    }
+  }
+  if(callEnableSWMR) {
+    // a SWMR reader process must see the summary of the flushed rows while the writer is still open (see summaryReader)
+    File file("testswmr.h5", writeType);
+    auto *ts=file.createChildObject<VectorSerie<double> >("summary")(
+      2, Options{}._chunkSize(4)._summaryLevels(3)._summaryBlockRows(4));
+    auto *reserve=file.createChildObject<VectorSerie<double> >("reserve")(1, Options{}._chunkSize(4)._cacheSize(1)._reserveExtent(true));
+    auto *slotAsync=file.createChildObject<VectorSerie<double> >("slotAsync")(1, Options{}._cacheSize(4)._asyncWrite(true));
+    auto *slotDirect=file.createChildObject<VectorSerie<double> >("slotDirect")(1, Options{}._chunkSize(4)._directChunkWrite(true));
+    auto *trigger=file.createChildObject<VectorSerie<double> >("trigger")(1);
+    file.enableSWMR();
+    for(int i=0; i<37; ++i)
+      ts->append(vector<double>{static_cast<double>(i), -1.0*i});
+    file.flush();
+    if(system(("\""+testlibExe+"\" summaryreader").c_str())!=0) {
+      cerr<<"Wrong summary seen by a SWMR reader"<<endl;
+      return 1;
+    }
+    // a reader (of this process) sees only the rows flushed by the writer, not the rows reserved by it
+    for(int i=0; i<3; ++i)
+      reserve->append(vector<double>{static_cast<double>(i+1)});
+    file.flush();
+    File reader("testswmr.h5", File::read);
+    auto *ts2=reader.openChildObject<VectorSerie<double> >("reserve");
+    if(ts2->getRows()!=3 || ts2->getRow(2)[0]!=3) {
+      cerr<<"Wrong number of rows with reserved extent"<<endl;
+      return 1;
+    }
+    for(int i=3; i<5; ++i)
+      reserve->append(vector<double>{static_cast<double>(i+1)}); // grows the extent to 8 rows
+    reader.refresh();
+    if(ts2->getRows()!=3) {
+      cerr<<"Wrong number of rows with reserved extent"<<endl;
+      return 1;
+    }
+    file.flush();
+    reader.refresh();
+    // the flush does not trim the reserved extent
+    if(ts2->getRows()!=5 || ts2->getRow(3)[0]!=4 || ts2->getRow(4)[0]!=5 || reserve->getExtentDims()[0]!=8) {
+      cerr<<"Wrong row after refresh"<<endl;
+      return 1;
+    }
+    // an auto-flush triggered by another dataset does not write the row returned by appendSlot before it is filled
+    file.setAutoFlush(0ms, 2);
+    for(auto *slot : {slotAsync, slotDirect}) {
+      for(int i=0; i<3; ++i)
+        slot->appendSlot()[0]=i+1;
+      double *row=slot->appendSlot(); // the last row of the cache block
+      row[0]=-1; // not filled yet
+      for(int i=0; i<2; ++i)
+        trigger->append(vector<double>{static_cast<double>(i)});
+      row[0]=4;
+      reader.refresh();
+      auto *slotReader=reader.openChildObject<VectorSerie<double> >(slot->getName());
+      if(slotReader->getRows()!=3 || slotReader->getRow(2)[0]!=3) {
+        cerr<<"Wrong rows flushed while an appendSlot row is pending"<<endl;
+        return 1;
+      }
+      slot->appendSlot()[0]=5;
+      file.flush();
+      reader.refresh();
+      if(slotReader->getRows()!=4 || slotReader->getRow(3)[0]!=4) {
+        cerr<<"Wrong rows flushed while an appendSlot row is pending"<<endl;
+        return 1;
+      }
+    }
+  }
 
 
 
@@ -630,6 +1093,10 @@ int worker(File::FileAccess writeType, bool callEnableSWMR) {
   for(auto & r : out)
     for(double c : r)
       cout<<c<<endl;
+  if(d->readRow(1)!=d2 || d->readRows(0, 2)!=data || !d->readRows(2, 0).empty()) {
+    cerr<<"Wrong partial read"<<endl;
+    return 1;
+  }
   if(callEnableSWMR)
     file.enableSWMR();
   }
@@ -677,6 +1144,10 @@ int worker(File::FileAccess writeType, bool callEnableSWMR) {
   for(auto & r : out)
     for(auto & c : r)
       cout<<c<<"."<<endl;
+  if(d->readRow(1)!=out[1]) {
+    cerr<<"Wrong partial read"<<endl;
+    return 1;
+  }
   }
 
   /***** Dataset vector<vector<complex<double>>> *****/
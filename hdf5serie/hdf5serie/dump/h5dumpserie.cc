@@ -22,6 +22,8 @@
 #ifdef _WIN32
 #  define WIN32_LEAN_AND_MEAN
 #  include <windows.h>
+#  include <io.h>
+#  include <fcntl.h>
 #endif
 #include <config.h>
 #include <clocale>
@@ -33,6 +35,10 @@
 #include <hdf5serie/toh5type.h>
 #include <iomanip>
 #include <limits>
+#include <charconv>
+#include <numeric>
+#include <deque>
+#include <thread>
 #include <boost/lexical_cast.hpp>
 #include <boost/format.hpp>
 
@@ -69,20 +75,48 @@ string delim=" ";
 string mynan="nan";
 int precision=numeric_limits<double>::digits10+1;
 
-enum class DSType {
-  simpleDataSet1D,
-  simpleDataSet2D,
-  vectorSerie,
+enum class OutputMode {
+  text,   // a ascii table
+  binary, // the raw values as native doubles (row-major)
+  npy,    // the raw values as a NumPy .npy file
 };
 
-using VariantVectorCTYPE = variant<
-#   define FOREACHKNOWNTYPE(CTYPE, H5TYPE) vector<CTYPE>,
-#   include "hdf5serie/knowntypes.def"
-#   undef FOREACHKNOWNTYPE
-    nullptr_t
->;
+// number of rows of all datasets read at once (and formatted by one task of the formatter pool)
+constexpr size_t blockRows=1024;
 
-void printRow(Dataset *d, DSType dsType, hid_t atomType, VariantVectorCTYPE &buf, const vector<int> &cols, int row);
+// A block of rows (of the selected columns) read from a dataset.
+// Blocks are read by the main thread (HDF5) and formatted by the formatter threads.
+class Block {
+  public:
+    virtual ~Block() = default;
+    //! append the values of row (relative to the first row of the block) to out (prefixed by delim if not first)
+    virtual void format(size_t row, bool first, string &out) const = 0;
+    //! append the values of row (relative to the first row of the block) as native doubles to out
+    virtual void binary(size_t row, string &out) const = 0;
+};
+
+// A dataset to dump: the type dispatch happens once per dataset when the source is created.
+class Source {
+  public:
+    Source(size_t rows_, vector<int> cols_) : rows(rows_), cols(std::move(cols_)) {
+      // the column numbers are 1-based on the command line
+      for(auto &c : cols)
+        c--;
+    }
+    virtual ~Source() = default;
+    size_t getRows() const { return rows; }
+    size_t getColumns() const { return cols.size(); }
+    //! return true if the values can be converted to double (for binary output)
+    virtual bool isReal() const = 0;
+    //! read the rows [first, first+n[
+    virtual shared_ptr<const Block> read(size_t first, size_t n) = 0;
+  protected:
+    size_t rows;
+    vector<int> cols; // 0-based
+};
+
+shared_ptr<Source> createSource(Dataset *d, const vector<int> &cols, size_t rows);
+void writeNpyHeader(size_t rows, size_t cols);
 
 int main(int argc, char* argv[]) {
 #ifdef _WIN32
@@ -155,7 +189,32 @@ int main(int argc, char* argv[]) {
     arg.erase(i, i+2);
   }
 
-  unsigned int maxrows=0;
+  i=find(arg.begin(), arg.end(), "-j");
+  size_t nrThreads=thread::hardware_concurrency();
+  if(i!=arg.end()) {
+    nrThreads=boost::lexical_cast<size_t>(*(i+1));
+    arg.erase(i, i+2);
+  }
+
+  OutputMode outputMode=OutputMode::text;
+  i=find(arg.begin(), arg.end(), "--binary");
+  if(i!=arg.end()) {
+    outputMode=OutputMode::binary;
+    arg.erase(i);
+  }
+  i=find(arg.begin(), arg.end(), "--npy");
+  if(i!=arg.end()) {
+    outputMode=OutputMode::npy;
+    arg.erase(i);
+  }
+  if(outputMode!=OutputMode::text) {
+    header=false;
+#ifdef _WIN32
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+  }
+
+  size_t maxrows=0;
   vector<vector<int> > column(arg.size());
   vector<Dataset*> dataSet(arg.size());
   vector<std::shared_ptr<File> > file(arg.size());
@@ -198,7 +257,7 @@ int main(int argc, char* argv[]) {
       columns=1;
     if(dims.size()==2)
       columns=dims[1];
-    maxrows=maxrows>dims[0]?maxrows:dims[0];
+    maxrows=max<size_t>(maxrows, dims[0]);
     while((i=columnname.find(','))>0) {
       string columnstr=columnname.substr(0,i);
       columnname=columnname.substr(i+1);
@@ -256,128 +315,234 @@ int main(int argc, char* argv[]) {
     }
   }
 
-  vector<DSType> dsType(arg.size());
-  vector<hid_t> atomType(arg.size());
-  vector<VariantVectorCTYPE> buf(arg.size());
+  vector<shared_ptr<Source>> source(arg.size());
+  size_t nrColumns=0;
   for(unsigned int k=0; k<arg.size(); k++) {
-#   define FOREACHKNOWNTYPE(CTYPE, H5TYPE) \
-    { \
-      if(auto *dd=dynamic_cast<VectorSerie<CTYPE>*>(dataSet[k]); dd) { \
-        dsType[k] = DSType::vectorSerie; \
-        atomType[k] = H5TYPE; \
-        buf[k] = vector<CTYPE>(dd->getColumns()); \
-      } \
-    }
-#   include "hdf5serie/knowntypes.def"
-#   undef FOREACHKNOWNTYPE
-
-#   define FOREACHKNOWNTYPE(CTYPE, H5TYPE) \
-    { \
-      if(auto *dd=dynamic_cast<SimpleDataset<vector<CTYPE> >*>(dataSet[k]); dd) { \
-        dsType[k] = DSType::simpleDataSet1D; \
-        atomType[k] = H5TYPE; \
-      } \
+    vector<hsize_t> dims=dataSet[k]->getExtentDims();
+    if(dims.empty())
+      continue;
+    source[k]=createSource(dataSet[k], column[k], dims[0]);
+    if(!source[k]) {
+      cerr<<"Unsupported dataset type: "<<arg[k]<<endl;
+      return 1;
     }
-#   include "hdf5serie/knowntypes.def"
-#   undef FOREACHKNOWNTYPE
-
-#   define FOREACHKNOWNTYPE(CTYPE, H5TYPE) \
-    { \
-      if(auto *dd=dynamic_cast<SimpleDataset<vector<vector<CTYPE> > >*>(dataSet[k]); dd) { \
-        dsType[k] = DSType::simpleDataSet2D; \
-        atomType[k] = H5TYPE; \
-      } \
+    if(outputMode!=OutputMode::text && !source[k]->isReal()) {
+      cerr<<"Only datasets of real numbers can be dumped in binary format: "<<arg[k]<<endl;
+      return 1;
     }
-#   include "hdf5serie/knowntypes.def"
-#   undef FOREACHKNOWNTYPE
+    nrColumns+=source[k]->getColumns();
   }
 
-  cout<<setprecision(precision)<<scientific;
-  for(unsigned int row=0; row<maxrows; row++) {
-    for(unsigned int k=0; k<arg.size(); k++) {
-      // Output mynan for to short datasets
-      vector<hsize_t> dims=dataSet[k]->getExtentDims();
-      if(row>=dims[0]) {
-        for(unsigned int i=0; i<column[k].size(); i++)
-          cout<<(k==0&&i==0?"":delim)<<mynan;
-        continue;
+  if(outputMode==OutputMode::npy)
+    writeNpyHeader(maxrows, nrColumns);
+
+  // the datasets are read by this thread block by block, each block is formatted by a task of the pool and
+  // the formatted blocks are written in order
+  Internal::ThreadPool pool(nrThreads);
+  deque<shared_future<string>> pending;
+  auto writePending = [&pending]() {
+    auto str=pending.front().get();
+    cout.write(str.data(), str.size());
+    pending.pop_front();
+  };
+  for(size_t firstRow=0; firstRow<maxrows; firstRow+=blockRows) {
+    size_t n=min<size_t>(blockRows, maxrows-firstRow);
+    struct BlockInfo {
+      shared_ptr<const Block> block; // nullptr if the dataset has no rows in this block
+      size_t rows;
+      size_t cols;
+    };
+    vector<BlockInfo> blocks;
+    blocks.reserve(arg.size());
+    for(auto &s : source) {
+      if(s && firstRow<s->getRows()) {
+        size_t rows=min(n, s->getRows()-firstRow);
+        blocks.push_back({s->read(firstRow, rows), rows, s->getColumns()});
       }
-      
-      cout<<(k==0?"":delim);
-      printRow(dataSet[k], dsType[k], atomType[k], buf[k], column[k], row);
+      else
+        blocks.push_back({nullptr, 0, s ? s->getColumns() : 0});
     }
-    cout<<endl;
+    pending.emplace_back(pool.submit([blocks=std::move(blocks), n, outputMode]() {
+      string out;
+      for(size_t row=0; row<n; ++row) {
+        bool first=true;
+        for(auto &[block, rows, cols] : blocks) {
+          if(row<rows) {
+            if(outputMode==OutputMode::text)
+              block->format(row, first, out);
+            else
+              block->binary(row, out);
+            first=false;
+            continue;
+          }
+          // output mynan for to short datasets
+          for(size_t i=0; i<cols; i++) {
+            if(outputMode==OutputMode::text) {
+              out+=first ? "" : delim;
+              out+=mynan;
+            }
+            else {
+              double nan=numeric_limits<double>::quiet_NaN();
+              out.append(reinterpret_cast<const char*>(&nan), sizeof(double));
+            }
+            first=false;
+          }
+        }
+        if(outputMode==OutputMode::text)
+          out+='\n';
+      }
+      return out;
+    }));
+    while(pending.size()>2*max<size_t>(nrThreads, 1))
+      writePending();
   }
+  while(!pending.empty())
+    writePending();
+  cout.flush();
 
   return 0;
 }
 
-template<typename T>
-class Format {
+template<class T> struct IsComplex : false_type {};
+template<class T> struct IsComplex<complex<T>> : true_type {};
+
+template<class T>
+void format(const T &value, string &out) {
+  if constexpr (is_same_v<T, string>) {
+    auto data=value;
+    boost::replace_all(data, "\n", linefeed);
+    out+=quote;
+    out+=data;
+    out+=quote;
+  }
+  else if constexpr (is_same_v<T, char> || is_same_v<T, signed char> || is_same_v<T, unsigned char>)
+    out+=static_cast<char>(value); // as a character (like ostream)
+  else if constexpr (IsComplex<T>::value) {
+    string real, imag;
+    format(value.real(), real);
+    format(value.imag(), imag);
+    out+=(boost::format(complexFormat)%real%imag).str();
+  }
+  else {
+    // equals ostream<<setprecision(precision)<<scientific<<value but is much faster
+    size_t pos=out.size();
+    out.resize(pos+max(precision, 0)+32);
+    to_chars_result res;
+    if constexpr (is_floating_point_v<T>)
+      res=to_chars(out.data()+pos, out.data()+out.size(), value, chars_format::scientific, precision);
+    else
+      res=to_chars(out.data()+pos, out.data()+out.size(), value);
+    out.resize(res.ptr-out.data());
+  }
+}
+
+// the values of a block stored column-major
+template<class T>
+class TypedBlock : public Block {
   public:
-    Format(const T& data_) : data(data_) {}
-    const T& data;
+    TypedBlock(size_t rows_, size_t cols) : rows(rows_), data(rows*cols) {}
+    void format(size_t row, bool first, string &out) const override {
+      for(size_t i=row; i<data.size(); i+=rows) {
+        if(!first)
+          out+=delim;
+        ::format(data[i], out);
+        first=false;
+      }
+    }
+    void binary(size_t row, string &out) const override {
+      if constexpr (is_arithmetic_v<T>)
+        for(size_t i=row; i<data.size(); i+=rows) {
+          auto value=static_cast<double>(data[i]);
+          out.append(reinterpret_cast<const char*>(&value), sizeof(double));
+        }
+    }
+    size_t rows;
+    vector<T> data;
 };
-template<typename T>
-ostream& operator<<(ostream& os, const Format<T>& format) {
-  os<<format.data;
-  return os;
-}
-template<>
-ostream& operator<<(ostream& os, const Format<string>& format) {
-  auto data = format.data;
-  boost::replace_all(data, "\n", linefeed);
-  os<<quote<<data<<quote;
-  return os;
-}
-template<typename T>
-ostream& operator<<(ostream& os, const Format<complex<T>>& format) {
-  stringstream strR;
-  strR<<setprecision(precision)<<scientific;
-  strR<<format.data.real();
-  stringstream strI;
-  strI<<setprecision(precision)<<scientific;
-  strI<<format.data.imag();
-  os<<boost::format(complexFormat)%strR.str()%strI.str();
-  return os;
-}
 
-void printRow(Dataset *d, DSType dsType, hid_t atomType, VariantVectorCTYPE &buf, const vector<int> &cols, int row) {
-# define FOREACHKNOWNTYPE(CTYPE, H5TYPE) \
-  { \
-    if(dsType==DSType::vectorSerie && atomType==H5TYPE) { \
-      VectorSerie<CTYPE> *dd=static_cast<VectorSerie<CTYPE>*>(d); \
-      dd->getRow(row, std::get<vector<CTYPE>>(buf)); \
-      bool first=true; \
-      for(auto i : cols) { \
-        cout<<(first?"":delim)<<Format(std::get<vector<CTYPE>>(buf)[i-1]); \
-        first=false; \
-      } \
-    } \
-  }
-# include "hdf5serie/knowntypes.def"
-# undef FOREACHKNOWNTYPE
+template<class T>
+class TypedSource : public Source {
+  public:
+    using Source::Source;
+    bool isReal() const override { return is_arithmetic_v<T>; }
+};
 
-# define FOREACHKNOWNTYPE(CTYPE, H5TYPE) \
-  { \
-    if(dsType==DSType::simpleDataSet1D && atomType==H5TYPE) { \
-      SimpleDataset<vector<CTYPE> > *dd=static_cast<SimpleDataset<vector<CTYPE> >*>(d); \
-      vector<CTYPE> vec=dd->read(); \
-      cout<<Format(vec[row]); \
-    } \
-  }
-# include "hdf5serie/knowntypes.def"
-# undef FOREACHKNOWNTYPE
+template<class T>
+class VectorSerieSource : public TypedSource<T> {
+  public:
+    VectorSerieSource(VectorSerie<T> *d_, const vector<int> &cols_, size_t rows_) : TypedSource<T>(rows_, cols_), d(d_) {}
+    shared_ptr<const Block> read(size_t first, size_t n) override {
+      auto block=make_shared<TypedBlock<T>>(n, this->cols.size());
+      d->getColumns(this->cols, first, n, block->data.data());
+      return block;
+    }
+  private:
+    VectorSerie<T> *d;
+};
+
+template<class T>
+class SimpleDataset1DSource : public TypedSource<T> {
+  public:
+    // the column selection is ignored: the single column is dumped
+    SimpleDataset1DSource(SimpleDataset<vector<T>> *d_, size_t rows_) : TypedSource<T>(rows_, {1}), d(d_) {}
+    shared_ptr<const Block> read(size_t first, size_t n) override {
+      auto block=make_shared<TypedBlock<T>>(n, 1);
+      auto vec=d->read(first, n); // only the rows of this block
+      copy(vec.begin(), vec.end(), block->data.begin());
+      return block;
+    }
+  private:
+    SimpleDataset<vector<T>> *d;
+};
 
+template<class T>
+class SimpleDataset2DSource : public TypedSource<T> {
+  public:
+    // the column selection is ignored: all columns are dumped
+    SimpleDataset2DSource(SimpleDataset<vector<vector<T>>> *d_, size_t rows_, size_t columns) : TypedSource<T>(rows_, allColumns(columns)), d(d_) {}
+    shared_ptr<const Block> read(size_t first, size_t n) override {
+      auto block=make_shared<TypedBlock<T>>(n, this->cols.size());
+      auto mat=d->readRows(first, n); // only the rows of this block
+      for(size_t i=0; i<this->cols.size(); ++i)
+        for(size_t r=0; r<n; ++r)
+          block->data[i*n+r]=std::move(mat[r][this->cols[i]]);
+      return block;
+    }
+  private:
+    SimpleDataset<vector<vector<T>>> *d;
+    static vector<int> allColumns(size_t columns) {
+      vector<int> cols(columns);
+      iota(cols.begin(), cols.end(), 1);
+      return cols;
+    }
+};
+
+shared_ptr<Source> createSource(Dataset *d, const vector<int> &cols, size_t rows) {
+  // the column selection is only used for VectorSerie, simple datasets are always dumped completely
 # define FOREACHKNOWNTYPE(CTYPE, H5TYPE) \
-  { \
-    if(dsType==DSType::simpleDataSet2D && atomType==H5TYPE) { \
-      SimpleDataset<vector<vector<CTYPE> > > *dd=static_cast<SimpleDataset<vector<vector<CTYPE> > >*>(d); \
-      vector<vector<CTYPE> > mat=dd->read(); \
-      for(size_t i=0; i<mat[0].size(); ++i) \
-        cout<<(i==0?"":delim)<<Format(mat[row][i]); \
-    } \
-  }
+  if(auto *dd=dynamic_cast<VectorSerie<CTYPE>*>(d); dd) \
+    return make_shared<VectorSerieSource<CTYPE>>(dd, cols, rows); \
+  if(auto *dd=dynamic_cast<SimpleDataset<vector<CTYPE> >*>(d); dd) \
+    return make_shared<SimpleDataset1DSource<CTYPE>>(dd, rows); \
+  if(auto *dd=dynamic_cast<SimpleDataset<vector<vector<CTYPE> > >*>(d); dd) \
+    return make_shared<SimpleDataset2DSource<CTYPE>>(dd, rows, d->getExtentDims()[1]);
 # include "hdf5serie/knowntypes.def"
 # undef FOREACHKNOWNTYPE
+  return nullptr;
+}
+
+void writeNpyHeader(size_t rows, size_t cols) {
+  // see https://numpy.org/doc/stable/reference/generated/numpy.lib.format.html (version 1.0)
+  uint16_t one=1;
+  bool littleEndian=*reinterpret_cast<char*>(&one)==1;
+  string dict="{'descr': '"s+(littleEndian ? "<" : ">")+"f8', 'fortran_order': False, 'shape': ("+
+              to_string(rows)+", "+to_string(cols)+"), }";
+  // magic string (6), version (2), header length (2), dict and padding to a multiple of 64, terminated by \n
+  dict.append(63-(10+dict.size())%64, ' ');
+  dict+='\n';
+  uint16_t len=dict.size();
+  cout.write("\x93NUMPY\x01\x00", 8);
+  char lenLE[]={static_cast<char>(len & 0xff), static_cast<char>(len>>8)};
+  cout.write(lenLE, 2);
+  cout.write(dict.data(), dict.size());
 }
@@ -25,6 +25,7 @@
 
 #include <config.h>
 #include <hdf5serie/file.h>
+#include "filter.h"
 #include <boost/interprocess/sync/file_lock.hpp>
 #include <boost/uuid/random_generator.hpp>
 #include <boost/uuid/uuid_io.hpp>
@@ -39,6 +40,10 @@
 #else
   #include <sys/vfs.h>
   #include <linux/magic.h>
+  #include <linux/futex.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+  #include <climits>
 #endif
 #if !defined(NDEBUG) && !defined(_WIN32)
   #include <boost/process.hpp>
@@ -61,6 +66,32 @@ namespace {
     }
   } init;
 
+#ifdef __linux__
+  // the polling interval of ConditionVariable: only a fallback since waiting threads are woken by the futex
+  constexpr chrono::milliseconds conditionPollInterval(1000);
+
+  // wait until word is no longer expected, a futexWake happens or timeout is exceeded (or spuriously)
+  void futexWait(atomic<uint32_t> &word, uint32_t expected, chrono::milliseconds timeout) {
+    timespec ts { static_cast<time_t>(timeout.count()/1000), static_cast<long>(timeout.count()%1000*1000000) };
+    // the futex is process shared (in shared memory) -> no FUTEX_PRIVATE_FLAG
+    // all errors (EAGAIN if word!=expected, EINTR, ETIMEDOUT) are handled by the caller by rechecking its condition
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+  }
+
+  void futexWakeAll(atomic<uint32_t> &word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+  }
+#else
+  constexpr chrono::milliseconds conditionPollInterval(1000/25);
+
+  void futexWait(atomic<uint32_t> &word, uint32_t expected, chrono::milliseconds timeout) {
+    this_thread::sleep_for(timeout);
+  }
+
+  void futexWakeAll(atomic<uint32_t> &word) {
+  }
+#endif
+
   auto now(const chrono::system_clock::time_point &currentTime = chrono::system_clock::now()) {
     auto t = chrono::system_clock::to_time_t(currentTime);
     auto local_t = *localtime(&t);
@@ -184,6 +215,8 @@ namespace H5 {
 int File::defaultCompression=1;
 int File::defaultChunkSize=100;
 int File::defaultCacheSize=100;
+bool File::defaultAsyncWrite=false;
+size_t File::defaultChunkCacheBudget=0;
 
 namespace Internal {
   // This class is similar to boost::interprocess::scoped_lock but prints debug messages.
@@ -231,23 +264,27 @@ namespace Internal {
       throw boost::interprocess::lock_exception();
     auto waiterUUID=boost::uuids::random_generator()();
     while(!pred()) {
+      uint32_t seq;
       {
         boost::interprocess::scoped_lock waiterLock(waiterMutex);
         if(waiter.size()==N)
           throw runtime_error("Too many threads are waiting in ConditionVariable.");
         if(find(waiter.begin(), waiter.end(), waiterUUID)==waiter.end())
           waiter.emplace_back(waiterUUID);
+        seq=notifySeq.load(); // a notify_all after this point changes notifySeq -> futexWait does not block
       }
       externLock.unlock();
 
       bool timeExceeded = false;
       bool exitLoop;
       do {
-        using namespace chrono_literals;
-        this_thread::sleep_for(1000ms/25);
+        auto elapsed=chrono::duration_cast<chrono::milliseconds>(std::chrono::steady_clock::now()-startTime);
+        futexWait(notifySeq, seq, relTime>elapsed ? min(conditionPollInterval, relTime-elapsed+chrono::milliseconds(1)) :
+                                                    chrono::milliseconds(0));
         {
           boost::interprocess::scoped_lock waiterLock(waiterMutex);
           exitLoop = find(waiter.begin(), waiter.end(), waiterUUID)==waiter.end();
+          seq=notifySeq.load();
         }
         if(std::chrono::steady_clock::now()-startTime>relTime) {
           boost::interprocess::scoped_lock waiterLock(waiterMutex);
@@ -269,9 +306,98 @@ namespace Internal {
 
   template<int N>
   void ConditionVariable<N>::notify_all() {
-    boost::interprocess::scoped_lock waiterLock(waiterMutex);
-    // no wakeup of all others needed since polling is used
-    waiter.clear();
+    {
+      boost::interprocess::scoped_lock waiterLock(waiterMutex);
+      waiter.clear();
+      notifySeq++;
+    }
+    // wakeup all waiting threads (the polling of the waiting threads is only a fallback)
+    futexWakeAll(notifySeq);
+  }
+
+  AsyncWriter::AsyncWriter(size_t maxQueueSize_) : maxQueueSize(max<size_t>(maxQueueSize_, 1)) {
+    thread=std::thread(&AsyncWriter::run, this);
+  }
+
+  AsyncWriter::~AsyncWriter() {
+    {
+      lock_guard lock(mutex);
+      exitThread=true;
+    }
+    cond.notify_all();
+    thread.join();
+  }
+
+  void AsyncWriter::push(function<void()> &&job) {
+    unique_lock lock(mutex);
+    cond.wait(lock, [this](){ return queue.size()<maxQueueSize; });
+    if(exception)
+      rethrow_exception(std::exchange(exception, nullptr));
+    queue.emplace_back(std::move(job));
+    lock.unlock();
+    cond.notify_all();
+  }
+
+  void AsyncWriter::wait(const function<bool()> &pred) {
+    unique_lock lock(mutex);
+    cond.wait(lock, [this, &pred](){ return pred() || exception; });
+    if(exception)
+      rethrow_exception(std::exchange(exception, nullptr));
+  }
+
+  // executed in a thread
+  void AsyncWriter::run() {
+    installErrorHandler();
+    unique_lock lock(mutex);
+    while(true) {
+      cond.wait(lock, [this](){ return !queue.empty() || exitThread; });
+      if(queue.empty()) // exitThread is set and all jobs are done
+        break;
+      auto job=std::move(queue.front());
+      queue.pop_front();
+      lock.unlock();
+      cond.notify_all(); // a slot in the queue is free now
+      try {
+        job();
+      }
+      catch(...) {
+        lock_guard lock2(mutex);
+        if(!exception) // keep the first exception
+          exception=current_exception();
+      }
+      lock.lock();
+      cond.notify_all(); // a job has finished
+    }
+  }
+
+  ThreadPool::ThreadPool(size_t nrThreads) {
+    for(size_t i=0; i<max<size_t>(nrThreads, 1); ++i)
+      threads.emplace_back(&ThreadPool::run, this);
+  }
+
+  ThreadPool::~ThreadPool() {
+    {
+      lock_guard lock(mutex);
+      exitThreads=true;
+    }
+    cond.notify_all();
+    for(auto &t : threads)
+      t.join();
+  }
+
+  // executed in a thread
+  void ThreadPool::run() {
+    unique_lock lock(mutex);
+    while(true) {
+      cond.wait(lock, [this](){ return !queue.empty() || exitThreads; });
+      if(queue.empty()) // exitThreads is set and all tasks are done
+        break;
+      auto task=std::move(queue.front());
+      queue.pop_front();
+      lock.unlock();
+      task(); // exceptions are passed to the future by packaged_task
+      lock.lock();
+    }
   }
 }
 
@@ -359,6 +485,17 @@ File::File(const boost::filesystem::path &filename_, FileAccess type_,
   renameAtomicFunc(renameAtomicFunc_),
   processUUID(boost::uuids::random_generator()()) {
 
+  // the filters of hdf5serie must be available before any dataset is created or read
+  registerFilters();
+
+  chunkCache.setBudget(defaultChunkCacheBudget);
+  const static std::chrono::milliseconds defaultMinFlushInterval(Settings::getValue("flush/minInterval", 0));
+  minFlushInterval=defaultMinFlushInterval;
+  const static std::chrono::milliseconds defaultAutoFlushInterval(Settings::getValue("autoFlush/interval", 0));
+  const static size_t defaultAutoFlushRows=Settings::getValue("autoFlush/rows", 0);
+  autoFlushInterval=defaultAutoFlushInterval;
+  autoFlushRows=defaultAutoFlushRows;
+
   if(getType()==read && !boost::filesystem::exists(filename))
     throw Exception({}, "No such HDF5 file to open: "+filename.string());
 
@@ -502,19 +639,22 @@ namespace {
   }
 }
 
-void File::openWriter() {
+void File::openWriter(bool reopen) {
   // create file
   msg(Atom::Debug)<<"HDF5Serie: "<<now()<<": "<<getFilename().string()<<": Create HDF5 file"<<endl;
   ScopedHID faid(H5Pcreate(H5P_FILE_ACCESS), &H5Pclose);
   checkCall(H5Pset_libver_bounds(faid, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST));
   checkCall(H5Pset_fclose_degree(faid, H5F_CLOSE_SEMI));
+  // align all larger allocations (chunks) to 16 bytes: allows zero-copy reads of uncompressed chunks (see VectorSerie::mapChunk)
+  if(chunkAlignment)
+    checkCall(H5Pset_alignment(faid, 64, 16));
   // Disable file locking: we use our own locking mechanism
   #if !H5_VERSION_LE(1, 10, 6)
     // HDF5 >= 1.10.7 reads this envvar only at library load time but has a property to disable file locking -> use this
     checkCall(H5Pset_file_locking(faid, false, true));
   #endif
   checkIfFileIsOpenedBySomeone("File::openWriter::precreate/preopen", getFilename());
-  if(type==write || (type==writeWithRename && preSWMR)) {
+  if(!reopen && (type==write || (type==writeWithRename && preSWMR))) {
     ScopedHID file_creation_plist(H5Pcreate(H5P_FILE_CREATE), &H5Pclose);
     checkCall(H5Pset_link_creation_order(file_creation_plist, H5P_CRT_ORDER_TRACKED | H5P_CRT_ORDER_INDEXED));
     retryOnLockError(getFilename().string(), [this, &faid, &file_creation_plist](){
@@ -607,6 +747,7 @@ void File::preOpenReader() {
     return sharedData->writerState==WriterState::none || sharedData->writerState==WriterState::swmr;
   });
   lastWriterState=sharedData->writerState;
+  lastFlushDoneEpoch=sharedData->flushDoneEpoch;
   // increment the active readers count and notify about this change
   msg(Atom::Debug)<<"HDF5Serie: "<<now()<<": "<<getFilename().string()<<": Increment activeReaders and notify"<<endl;
   sharedData->activeReaders++;
@@ -766,46 +907,160 @@ void File::postCloseReader() {
 
 void File::refresh() {
   assert(getType()==read && "refresh() can only be called on files opened for reading");
-  GroupBase::refresh();
+  if(!refreshSubscribedOnly) {
+    GroupBase::refresh();
+    return;
+  }
+  for(auto &[dataset, count] : subscriptions)
+    dataset->refresh();
+}
+
+void File::subscribe(Dataset *dataset) {
+  assert(getType()==read && "subscribe() can only be called on files opened for reading");
+  if(dataset->getFile()!=this)
+    throw Exception(getPath(), "Cannot subscribe the dataset "+dataset->getPath()+" of another file");
+  refreshSubscribedOnly=true;
+  if(subscriptions[dataset]++==0)
+    dataset->refresh();
+}
+
+void File::unsubscribe(Dataset *dataset) {
+  auto it=subscriptions.find(dataset);
+  if(it==subscriptions.end())
+    throw Exception(getPath(), "Cannot unsubscribe the dataset "+dataset->getPath()+" since it is not subscribed");
+  if(--it->second==0)
+    subscriptions.erase(it);
 }
 
 bool File::requestFlush() {
   assert(getType()==read && "requestFlush() can only be called on files opened for reading");
   ScopedLock lock(sharedData->mutex, this, "requestFlush");
   if(msgAct(Atom::Debug))
-    msg(Atom::Debug)<<"HDF5Serie: "<<now()<<": "<<getFilename().string()<<": Set flushRequest and notify"<<endl;
-  sharedData->flushRequest=true;
-  flushRequested=true;
+    msg(Atom::Debug)<<"HDF5Serie: "<<now()<<": "<<getFilename().string()<<": Increment flushRequestEpoch and notify"<<endl;
+  sharedData->flushRequestEpoch++;
   sharedData->cond.notify_all(); // not really needed since we assume that the writer is polling on this flag frequently.
   return sharedData->writerState==WriterState::swmr;
 }
 
 void File::flushIfRequested(const function<void(File*)> &postFlushFunc) {
   assert(getType()==write && "flushIfRequested() can only be called on files opened for writing");
-  {
-    ScopedLock lock(sharedData->mutex, this, "flushIfRequested, before flush");
-    if(!sharedData->flushRequest) {
-      if(msgAct(Atom::Debug))
-        msg(Atom::Debug)<<"HDF5Serie: "<<now()<<": "<<getFilename().string()<<": No flush request"<<endl;
-      return;
-    }
+  // this is called very often by the writer: check the lock-free status word without locking the mutex
+  // (flushDoneEpoch is only changed by this writer, hence it cannot change until the flush is done)
+  uint32_t requestEpoch=sharedData->flushRequestEpoch.load(memory_order_relaxed);
+  if(requestEpoch==sharedData->flushDoneEpoch.load(memory_order_relaxed)) {
+    if(msgAct(Atom::Debug))
+      msg(Atom::Debug)<<"HDF5Serie: "<<now()<<": "<<getFilename().string()<<": No flush request"<<endl;
+    return;
   }
+  // rate-limit the flushes: keep the request pending if the last flush is too short ago
+  auto curTime=std::chrono::steady_clock::now();
+  if(minFlushInterval.count()>0 && curTime-lastFlushTime<minFlushInterval) {
+    if(msgAct(Atom::Debug))
+      msg(Atom::Debug)<<"HDF5Serie: "<<now()<<": "<<getFilename().string()<<": Flush request delayed (minimal flush interval)"<<endl;
+    return;
+  }
+  lastFlushTime=curTime;
+
+  flushAndNotify(requestEpoch, postFlushFunc);
+}
 
-  // flush file (and datasets) and reset flushRequest flag and notify
+void File::flushAndNotify(uint32_t requestEpoch, const function<void(File*)> &postFlushFunc) {
+  // flush file (and datasets), set flushDoneEpoch and notify
+  // (all requests up to requestEpoch are served by this flush, later requests need a further flush)
   if(msgAct(Atom::Debug))
     msg(Atom::Debug)<<"HDF5Serie: "<<now()<<": "<<getFilename().string()<<": Flushing now"<<endl;
-  GroupBase::flush();
+  flushDirtyDatasets();
 
   if(postFlushFunc)
     postFlushFunc(this);
 
-  ScopedLock lock(sharedData->mutex, this, "flushIfRequested, after flush");
+  ScopedLock lock(sharedData->mutex, this, "flushAndNotify, after flush");
   if(msgAct(Atom::Debug))
-    msg(Atom::Debug)<<"HDF5Serie: "<<now()<<": "<<getFilename().string()<<": Unset flushRequest and notify"<<endl;
-  sharedData->flushRequest=false;
+    msg(Atom::Debug)<<"HDF5Serie: "<<now()<<": "<<getFilename().string()<<": Set flushDoneEpoch and notify"<<endl;
+  sharedData->flushDoneEpoch=requestEpoch;
   sharedData->cond.notify_all();
 }
 
+void File::setAutoFlush(const std::chrono::milliseconds &interval, size_t rows) {
+  if(getType()!=write)
+    throw Exception(getPath(), "setAutoFlush() can only be called for writing files");
+  stopAutoFlush();
+  autoFlushInterval=interval;
+  autoFlushRows=rows;
+  if(sharedData->writerState==WriterState::swmr)
+    startAutoFlush();
+}
+
+void File::startAutoFlush() {
+  stopAutoFlush();
+  if(autoFlushInterval.count()<=0 && autoFlushRows==0)
+    return;
+  msg(Atom::Debug)<<"HDF5Serie: "<<now()<<": "<<getFilename().string()<<": Start auto-flush"<<endl;
+  autoFlushDue=false;
+  autoFlushActive=true;
+  if(autoFlushInterval.count()<=0)
+    return;
+  autoFlushExit=false;
+  autoFlushThread=thread([this](){
+    // this thread does not access HDF5: it just sets the flag which is checked by the writing thread in autoFlushPoint
+    unique_lock lock(autoFlushMutex);
+    while(!autoFlushCond.wait_for(lock, autoFlushInterval, [this](){ return autoFlushExit; }))
+      autoFlushDue.store(true, memory_order_relaxed);
+  });
+}
+
+void File::stopAutoFlush() {
+  autoFlushActive=false;
+  if(!autoFlushThread.joinable())
+    return;
+  msg(Atom::Debug)<<"HDF5Serie: "<<now()<<": "<<getFilename().string()<<": Stop auto-flush"<<endl;
+  {
+    lock_guard lock(autoFlushMutex);
+    autoFlushExit=true;
+  }
+  autoFlushCond.notify_all();
+  autoFlushThread.join();
+}
+
+void File::autoFlush() {
+  autoFlushDue.store(false, memory_order_relaxed);
+  // the writer flushes on its own: add a request to let all readers refresh (pending requests are served by this flush as well)
+  uint32_t requestEpoch;
+  {
+    ScopedLock lock(sharedData->mutex, this, "autoFlush");
+    requestEpoch=++sharedData->flushRequestEpoch;
+  }
+  lastFlushTime=std::chrono::steady_clock::now();
+  flushAndNotify(requestEpoch, {});
+}
+
+void File::flushDirtyDatasets() {
+  // datasets flushed by a full flush (or added twice) are not dirty anymore and are skipped
+  // (on an exception the remaining datasets stay in the list for the next flush)
+  for(size_t i=0; i<dirtyDatasets.size(); ++i)
+    if(dirtyDatasets[i]->isDirty())
+      dirtyDatasets[i]->flush();
+  for(auto *dataset : dirtyDatasets)
+    dataset->dirtyListed=false;
+  dirtyDatasets.clear();
+}
+
+void File::enableChunkAlignment() {
+  // datasets cannot be created in SWMR mode (H5Dcreate fails)
+  if(chunkAlignment || sharedData->writerState==WriterState::swmr)
+    return;
+  msg(Atom::Debug)<<"HDF5Serie: "<<now()<<": "<<getFilename().string()<<": reopen the file with chunk alignment"<<endl;
+  flush();
+  reopening=true;
+  GroupBase::close();
+  reopening=false;
+  dirtyDatasets.clear();
+  id.reset();
+  chunkAlignment=true;
+  openWriter(true);
+  GroupBase::reopen();
+}
+
 void File::enableSWMR() {
   if(getType()!=write)
     throw Exception(getPath(), "enableSWMR() can only be called for writing files");
@@ -878,6 +1133,8 @@ void File::enableSWMR() {
     sharedData->writerState=WriterState::swmr;
     sharedData->cond.notify_all();
   }
+
+  startAutoFlush();
 }
 
 void File::wait(ScopedLock &lock, const std::chrono::milliseconds& relTime,
@@ -910,15 +1167,15 @@ void File::listenForRequest() {
     // ... waits until write request happens (or this thread is to be closed)
     wait(threadLock, 1000*24*60*60*1000ms, "", [this](){ // use a reltime of 1000day for infinity
       return sharedData->writerState==WriterState::writeRequest || // the writer wants to write
-             (flushRequested && sharedData->flushRequest==false) || // this object has requested a flush which is done now
+             sharedData->flushDoneEpoch!=lastFlushDoneEpoch || // the writer has flushed (requested by any reader)
              (lastWriterState!=WriterState::none && sharedData->writerState==WriterState::none) || // writer has finished
              exitThread; // this thread should exit
     });
-    // if the writer has done is flush after a reqeust OR
+    // if the writer has done a flush after a reqeust OR
     // the writer has finished ...
-    if((flushRequested && sharedData->flushRequest==false) ||
+    if(sharedData->flushDoneEpoch!=lastFlushDoneEpoch ||
        (lastWriterState!=WriterState::none && sharedData->writerState==WriterState::none)) {
-      flushRequested=false;
+      lastFlushDoneEpoch=sharedData->flushDoneEpoch;
       // ... call the callback to notify the caller of this reader about the finished flush
       if(refreshCallback) {
         if(msgAct(Atom::Debug))
@@ -1001,7 +1258,8 @@ void File::dumpSharedMemory(const boost::filesystem::path &filename) {
     cout<<"activeReaders: "<<sharedData->activeReaders<<endl;
     for(auto &pi : sharedData->processes)
       cout<<"processes: UUID="<<pi.processUUID<<" lastAliveTime="<<pi.lastAliveTime<<" type="<<(pi.type == write ? "write": "read")<<endl;
-    cout<<"flushRequest: "<<sharedData->flushRequest<<endl;
+    cout<<"flushRequestEpoch: "<<sharedData->flushRequestEpoch<<endl;
+    cout<<"flushDoneEpoch: "<<sharedData->flushDoneEpoch<<endl;
 
     msgStatic(Atom::Debug)<<"HDF5Serie: "<<now()<<": "<<filename.string()<<": Unlock: dumpSharedMemory"<<endl;
   }
@@ -1009,7 +1267,8 @@ void File::dumpSharedMemory(const boost::filesystem::path &filename) {
 
 string File::createShmName(const boost::filesystem::path &filename) {
   auto absFilename=boost::filesystem::absolute(filename).lexically_normal().generic_string();
-  return "hdf5serie_shm_file_"+to_string(hash<string>{}(absFilename));
+  // the layout version is part of the name: processes using another layout use another shared memory
+  return "hdf5serie_shm_v"+to_string(sharedMemObjectVersion)+"_file_"+to_string(hash<string>{}(absFilename));
 }
 
 void File::removeSharedMemory(const boost::filesystem::path &filename) {
@@ -1021,10 +1280,96 @@ void File::removeSharedMemory(const boost::filesystem::path &filename) {
 }
 
 
+ThreadPool& ThreadPool::getCompressionPool() {
+  static ThreadPool pool([](){
+    int nrThreads=Settings::getValue("compression/threads", 0);
+    return nrThreads>0 ? static_cast<size_t>(nrThreads) : std::thread::hardware_concurrency();
+  }());
+  return pool;
+}
+
+shared_ptr<const ChunkCache::Entry> ChunkCache::get(const Key &key, size_t minRows) {
+  auto it=index.find(key);
+  if(it==index.end() || it->second->second->rows<minRows) {
+    stats.misses++;
+    return nullptr;
+  }
+  stats.hits++;
+  lru.splice(lru.begin(), lru, it->second); // mark as most recently used
+  return it->second->second;
+}
+
+void ChunkCache::put(const Key &key, shared_ptr<const Entry> entry) {
+  auto it=index.find(key);
+  if(it!=index.end()) {
+    stats.size-=it->second->second->bytes;
+    lru.erase(it->second);
+    index.erase(it);
+  }
+  if(entry->bytes>budget)
+    return; // the entry does not fit in the cache at all
+  stats.size+=entry->bytes;
+  lru.emplace_front(key, std::move(entry));
+  index.emplace(key, lru.begin());
+  shrink();
+}
+
+void ChunkCache::erase(const void *dataset) {
+  for(auto it=index.lower_bound({dataset, 0}); it!=index.end() && it->first.first==dataset;) {
+    stats.size-=it->second->second->bytes;
+    lru.erase(it->second);
+    it=index.erase(it);
+  }
+}
+
+void ChunkCache::clear() {
+  lru.clear();
+  index.clear();
+  stats.size=0;
+}
+
+void ChunkCache::setBudget(size_t bytes) {
+  budget=bytes;
+  shrink();
+}
+
+void ChunkCache::shrink() {
+  while(stats.size>budget) {
+    stats.size-=lru.back().second->bytes;
+    index.erase(lru.back().first);
+    lru.pop_back();
+  }
+}
+
+AsyncWriter* File::getAsyncWriter() {
+  if(!asyncWriter) {
+    hbool_t threadSafe;
+    checkCall(H5is_library_threadsafe(&threadSafe));
+    if(!threadSafe) {
+      static bool warningPrinted=false;
+      if(!warningPrinted) {
+        msg(Atom::Warn)<<"HDF5Serie: The HDF5 library is not thread-safe, asynchronous writing is disabled."<<endl;
+        warningPrinted=true;
+      }
+      return nullptr;
+    }
+    const static size_t maxQueueSize=Settings::getValue("asyncWrite/maxQueueSize", 16);
+    asyncWriter=make_unique<AsyncWriter>(maxQueueSize);
+  }
+  return asyncWriter.get();
+}
+
 void File::close() {
   msg(Atom::Debug)<<"HDF5Serie: "<<now()<<": "<<getFilename().string()<<": close file"<<endl;
+  // no auto-flush of a closed file
+  stopAutoFlush();
   // close everything (except the file itself)
   GroupBase::close();
+  // all datasets have drained there pending writes in close -> the writer thread can be exited
+  asyncWriter.reset();
+  chunkCache.clear();
+  dirtyDatasets.clear();
+  subscriptions.clear();
 
   if(id>=0) {
     // check if all object are closed now: if not -> throw internal error (with details about the opened objects)
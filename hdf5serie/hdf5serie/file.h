@@ -36,6 +36,14 @@
 #include <boost/uuid/uuid.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <thread>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <future>
 #include <boost/thread/thread.hpp>
 
 namespace H5 {
@@ -71,8 +79,10 @@ namespace H5 {
     // since boost::interprocess::interprocess:condition does not provide a robust condition on Linux.
     // A none robust condition variable is blocking in notify_all or dtor if a process waiting on the condition crashed!
     // The robustness is simply achived by polling in constant time intervalls instead of putting thread to sleep and wakeup.
-    // This polling delay is no problem in this scope since its only used for user visible things.
-    // So a polling delay of 1/25 second (25 frames per second) is used which equal the human visible reaction time.
+    // On Linux a waiting thread additionally sleeps on a futex (on the notify sequence number) which is woken by notify_all:
+    // the wakeup is immediate and the polling interval is increased to 1 second (it is only a fallback, e.g. if a
+    // notifying process crashed). On other platforms a polling delay of 1/25 second (25 frames per second) is used
+    // which equal the human visible reaction time.
     // The interface equals boost::interprocess::interprocess_condition but not with all member functions.
     // However, only N threads (which may be from different processes) can be waiting.
     // This class must be implemented in a address-free way since it is placed usually in shared memory.
@@ -91,10 +101,114 @@ namespace H5 {
       private:
         boost::container::static_vector<boost::uuids::uuid, N> waiter;
         boost::interprocess::interprocess_mutex waiterMutex;
+        std::atomic<uint32_t> notifySeq { 0 }; // incremented by each notify_all (the futex word on Linux)
+        static_assert(std::atomic<uint32_t>::is_always_lock_free, "the futex word must be address-free (in shared memory)");
+    };
+
+    // A writer thread executing the queued jobs in the order they were pushed.
+    // It is used by VectorSerie (if Options::asyncWrite is set) to move the HDF5 write calls of filled cache blocks
+    // off the thread calling append.
+    // The queue is bounded: push blocks while maxQueueSize jobs are pending.
+    // A exception thrown by a job is stored and rethrown by the next call to push or wait (on the calling thread).
+    class AsyncWriter {
+      public:
+        AsyncWriter(size_t maxQueueSize_);
+        AsyncWriter(const AsyncWriter&) = delete;
+        AsyncWriter& operator=(const AsyncWriter&) = delete;
+        //! Waits until all pending jobs are executed and exits the thread.
+        ~AsyncWriter();
+        //! Queue job for execution by the writer thread.
+        void push(std::function<void()> &&job);
+        //! Wait until pred returns true. pred is reevaluated each time a job has finished.
+        void wait(const std::function<bool()> &pred);
+      private:
+        void run();
+        size_t maxQueueSize;
+        std::deque<std::function<void()>> queue;
+        bool exitThread { false };
+        std::exception_ptr exception;
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::thread thread;
+    };
+
+    // A simple thread pool executing tasks in parallel.
+    // The library-wide pool returned by getCompressionPool is used to compress chunks of
+    // datasets with Options::directChunkWrite and Options::asyncWrite set.
+    class ThreadPool {
+      public:
+        ThreadPool(size_t nrThreads);
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        //! Executes all pending tasks and exits the threads.
+        ~ThreadPool();
+        //! Returns the library-wide pool for chunk compression.
+        //! Its size is read from the setting compression/threads (0 = number of hardware threads)
+        static ThreadPool& getCompressionPool();
+        //! Execute func in the pool. The returned future provides the result or the exception thrown by func.
+        template<class Func>
+        std::shared_future<std::invoke_result_t<Func>> submit(Func &&func) {
+          auto task=std::make_shared<std::packaged_task<std::invoke_result_t<Func>()>>(std::forward<Func>(func));
+          std::shared_future<std::invoke_result_t<Func>> ret=task->get_future();
+          {
+            std::lock_guard lock(mutex);
+            queue.emplace_back([task](){ (*task)(); });
+          }
+          cond.notify_one();
+          return ret;
+        }
+      private:
+        void run();
+        std::deque<std::function<void()>> queue;
+        bool exitThreads { false };
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::vector<std::thread> threads;
+    };
+
+    // A LRU cache of decompressed chunk rows shared by all datasets of a file opened for reading.
+    // VectorSerie::getRow (of datasets of arithmetic types) reads a full chunk row on a miss and serves the following rows from this cache.
+    // The least recently used entries are removed if the size of all entries exceeds the budget.
+    class ChunkCache {
+      public:
+        struct Entry {
+          virtual ~Entry() = default;
+          size_t rows { 0 }; // number of rows in data (the last chunk row of a growing dataset may be partial)
+          size_t bytes { 0 }; // the size of data
+        };
+        // the entries of a dataset of type T
+        template<class T>
+        struct TypedEntry : Entry {
+          std::vector<T> data;
+        };
+        struct Stats {
+          size_t hits { 0 };
+          size_t misses { 0 };
+          size_t size { 0 }; // the size of all entries in bytes
+        };
+        using Key = std::pair<const void*, size_t>; // the dataset and the chunk row index
+
+        //! Returns the entry of key if it exists and contains at least minRows rows, else nullptr.
+        std::shared_ptr<const Entry> get(const Key &key, size_t minRows);
+        //! Add (or replace) the entry of key.
+        void put(const Key &key, std::shared_ptr<const Entry> entry);
+        //! Remove all entries of dataset.
+        void erase(const void *dataset);
+        void clear();
+        void setBudget(size_t bytes);
+        size_t getBudget() const { return budget; }
+        const Stats& getStats() const { return stats; }
+      private:
+        void shrink();
+        size_t budget { 0 };
+        Stats stats;
+        std::list<std::pair<Key, std::shared_ptr<const Entry>>> lru; // the most recently used entry first
+        std::map<Key, decltype(lru)::iterator> index;
     };
   }
 
   class Dataset;
+  template<class T> class VectorSerie;
 
   /* A wrapper around a HDF5 file.
    * It handles automatically HDF5 SWMR access using a shared memory based inter-process communication:
@@ -105,6 +219,7 @@ namespace H5 {
    */
   class File : public GroupBase {
     friend class Internal::ScopedLock;
+    template<class T> friend class VectorSerie;
     public:
       enum FileAccess {
         read,            //!< Open file for reading with SWMR reading mode enabled
@@ -124,6 +239,8 @@ namespace H5 {
       //! After close (destruct) you can immediately reopen the file by constructing a File object (with the same HDF5 file) again.
       //! The inter process communication will ensure that the requested writer does its job before you can reopen the file for reading again.
       //! For a reader refreshCallback_ should also be set if the reader will call requestFlush.
+      //! It is called once for each flush of the writer (requested by this or any other reader) and when the writer has finished.
+      //! Flushes which happen while the callback is still running are coalesced into one further call.
       //! When this callback is called the reader should call refresh().
       //! Note that both callback functions will be called from a thread created by this constructor.
       //! If the file was opened with writeWithRename, then the function renameAtomicFunc is called immediately after the rename
@@ -146,9 +263,38 @@ namespace H5 {
       static void setDefaultChunkSize(int chunk) { defaultChunkSize=chunk; }
       static int getDefaultCacheSize() { return defaultCacheSize; }
       static void setDefaultCacheSize(int cache) { defaultCacheSize=cache; }
+      static bool getDefaultAsyncWrite() { return defaultAsyncWrite; }
+      static void setDefaultAsyncWrite(bool async) { defaultAsyncWrite=async; }
+      static size_t getDefaultChunkCacheBudget() { return defaultChunkCacheBudget; }
+      static void setDefaultChunkCacheBudget(size_t bytes) { defaultChunkCacheBudget=bytes; }
+
+      //! Set the budget (in bytes) of the chunk cache shared by all datasets of this file (only used by readers, 0 = disabled).
+      //! If enabled, VectorSerie::getRow reads (and caches) the full chunk row of the requested row.
+      //! The default is getDefaultChunkCacheBudget() (default 0 = disabled).
+      void setChunkCacheBudget(size_t bytes) { chunkCache.setBudget(bytes); }
+      size_t getChunkCacheBudget() const { return chunkCache.getBudget(); }
+      //! Returns the hits, misses and current size of the shared chunk cache.
+      const Internal::ChunkCache::Stats& getChunkCacheStats() const { return chunkCache.getStats(); }
+      //! Returns the shared chunk cache (used by the datasets of this file).
+      Internal::ChunkCache& getChunkCache() { return chunkCache; }
+
+      //! Returns the writer thread of this file which is used by datasets with Options::asyncWrite set.
+      //! The thread is created on the first call.
+      //! nullptr is returned if the HDF5 library is not thread-safe, the caller must write synchronously in this case.
+      Internal::AsyncWriter* getAsyncWriter();
 
-      //! Refresh the datasets of a reader
+      //! Refresh the datasets of a reader (all opened datasets or only the subscribed ones, see setRefreshSubscribedOnly).
       void refresh() override;
+      //! If true refresh() updates only the subscribed datasets (see subscribe), else all opened datasets.
+      //! The default is false; it is set to true by the first call of subscribe.
+      void setRefreshSubscribedOnly(bool subscribedOnly) { refreshSubscribedOnly=subscribedOnly; }
+      bool getRefreshSubscribedOnly() const { return refreshSubscribedOnly; }
+      //! Subscribe the dataset of a reader for refresh: refresh() updates only subscribed datasets (instead of all opened ones).
+      //! Subscriptions are counted: a dataset subscribed n times is unsubscribed after n calls of unsubscribe.
+      //! The dataset is refreshed when it gets subscribed since it may not have been updated by previous refresh() calls.
+      void subscribe(Dataset *dataset);
+      //! Unsubscribe a dataset subscribed by subscribe.
+      void unsubscribe(Dataset *dataset);
       //! Called by a reader to request a flush of the writer.
       //! This is not blocking. If the writer has flushed the refreshCallback is called, see constructor.
       //! If a writer process currently exists true is returned else false. Note that this returned flag cannot change
@@ -157,9 +303,39 @@ namespace H5 {
       //! This function should be called periodically for a file opened for writing.
       //! It flush's the file (the dataset) of a writer if such a flush was requested by a reader.
       //! Does nothing if no reader has requested a flush.
+      //! All requests pending at the time of the flush are served by this single flush.
+      //! If the last flush is less than getMinFlushInterval() ago the request is kept pending and served by a later call.
       //! If a flush happens postFlushFunc is called immediately after the flush ("this" is passed as argument)
       //! and than the readers are notified about the flush.
       void flushIfRequested(const std::function<void(File*)> &postFlushFunc={});
+      //! Set the minimal time between two flushes done by flushIfRequested (only used by writers).
+      //! This limits the flush rate if many readers request flushes frequently.
+      //! The default is taken from the config value flush/minInterval (in milliseconds, default 0 = no limit).
+      void setMinFlushInterval(const std::chrono::milliseconds &interval) { minFlushInterval=interval; }
+      const std::chrono::milliseconds& getMinFlushInterval() const { return minFlushInterval; }
+
+      //! Enable a periodic flush of a writer in SWMR mode (without the need to call flushIfRequested).
+      //! The file is flushed (and the readers are notified) if at least interval has elapsed since the last auto-flush
+      //! or if rows rows have been appended to a dataset since its last flush (0 = no limit for both).
+      //! A background thread only sets a flag when the interval has elapsed: the flush itself is done by the writing thread
+      //! during the next append call of any VectorSerie of this file (hence, no data is flushed while no rows are appended).
+      //! The default is taken from the config values autoFlush/interval (in milliseconds) and autoFlush/rows (both default 0 = disabled).
+      void setAutoFlush(const std::chrono::milliseconds &interval, size_t rows=0);
+      const std::chrono::milliseconds& getAutoFlushInterval() const { return autoFlushInterval; }
+      size_t getAutoFlushRows() const { return autoFlushRows; }
+
+      //! Called by a dataset if it gets modified (see Dataset::markDirty): only such datasets are flushed by flushIfRequested.
+      //! Each dataset is added only once until the list is flushed by flushIfRequested or auto-flush.
+      void addDirtyDataset(Dataset *dataset) { dirtyDatasets.push_back(dataset); }
+      //! Returns the number of datasets in the list of modified datasets.
+      size_t getDirtyDatasetCount() const { return dirtyDatasets.size(); }
+
+      //! Called by the datasets after appending rows (rowsSinceFlush is the number of rows appended to the dataset since its last flush).
+      //! Flushes the file if the auto-flush budget is exceeded, see setAutoFlush.
+      void autoFlushPoint(size_t rowsSinceFlush) {
+        if(autoFlushActive && (autoFlushDue.load(std::memory_order_relaxed) || (autoFlushRows>0 && rowsSinceFlush>=autoFlushRows)))
+          autoFlush();
+      }
 
       //! Internal helper function which dumps the content of the shared memory associated with filename.
       //! !!! Note that the shared memory mutex is NOT locked for this operation but the global named mutex to create/open and destroy lock is accquired.
@@ -173,9 +349,42 @@ namespace H5 {
       static int defaultCompression;
       static int defaultChunkSize;
       static int defaultCacheSize;
+      static bool defaultAsyncWrite;
+      static size_t defaultChunkCacheBudget;
 
       void close() override;
 
+      //! The chunk cache shared by all datasets, see setChunkCacheBudget
+      Internal::ChunkCache chunkCache;
+
+      //! True if all larger allocations (the chunks) of the writer are aligned to 16 bytes, see enableChunkAlignment
+      bool chunkAlignment { false };
+      //! True while the elements are closed by enableChunkAlignment to reopen the file
+      bool reopening { false };
+      //! Align all larger allocations of the writer to 16 bytes from now on (called by datasets with Options::alignChunks).
+      //! HDF5 aligns allocations only for the whole file (a file access property): all elements are closed and the file is reopened.
+      void enableChunkAlignment();
+
+      //! The writer thread, see getAsyncWriter
+      std::unique_ptr<Internal::AsyncWriter> asyncWriter;
+
+      //! The auto-flush budget, see setAutoFlush
+      std::chrono::milliseconds autoFlushInterval { 0 };
+      size_t autoFlushRows { 0 };
+      //! True if auto-flush is enabled and the writer is in SWMR mode
+      bool autoFlushActive { false };
+      //! Set by autoFlushThread if autoFlushInterval has elapsed, reset by autoFlush
+      std::atomic<bool> autoFlushDue { false };
+      //! The thread setting autoFlushDue periodically (only running if autoFlushInterval>0)
+      std::thread autoFlushThread;
+      std::mutex autoFlushMutex;
+      std::condition_variable autoFlushCond;
+      bool autoFlushExit { false }; // guarded by autoFlushMutex
+      void startAutoFlush();
+      void stopAutoFlush();
+      //! Flush the file and notify the readers (called by autoFlushPoint)
+      void autoFlush();
+
       //! The name of the file
       boost::filesystem::path filename;
       boost::filesystem::path getFilename(bool originalFilename=false); // gets the filename dependent on the current preSWMR
@@ -205,7 +414,9 @@ namespace H5 {
       };
       //! This struct holds synchronization primitives and states for inter-process communication.
       //! One such object exists in process shared memory for each file (so multiple instances of the File object can share it).
-      //! All access to all members of this object must be guarded by locking sharedData->mutex (interprocess wide)
+      //! All access to all members of this object must be guarded by locking sharedData->mutex (interprocess wide).
+      //! Exceptions are the atomic status words writerState, flushRequestEpoch and flushDoneEpoch: they are only changed with
+      //! the mutex locked but can be read lock-free (e.g. flushIfRequested checks the epochs without locking the mutex).
       struct SharedMemObject {
         // the following member is only used for life-time handling of the shared memroy object itself
         size_t shmUseCount { 0 }; //<! the number users of this shared memory object
@@ -214,13 +425,21 @@ namespace H5 {
         Internal::ConditionVariable<MAXREADERS+MAXWRITERS> cond; //<! a condition variable for signaling state changes.
         // the following members represent the state of the writer and readers
         // after setting any of these variables sharedData->cond.notify_all() must be called to notify all waiting process about the change
-        WriterState writerState { WriterState::none }; //<! the current state of the write of this file.
+        std::atomic<WriterState> writerState { WriterState::none }; //<! the current state of the write of this file.
         size_t activeReaders { 0 };                    //<! the number of active readers on this file.
         // the follwing members are only used for still-alive/crash detection handling
         boost::container::static_vector<ProcessInfo, MAXREADERS+1> processes; //<! a list of all processes accessing the shared memory
         // the follwing members are only used for flush/refresh handling
-        bool flushRequest { false }; //<! Is set to true by reader if a flush of the writer should be done. The writer resets to false after a flush.
+        std::atomic<uint32_t> flushRequestEpoch { 0 }; //<! Is incremented by a reader if a flush of the writer should be done.
+        std::atomic<uint32_t> flushDoneEpoch { 0 }; //<! Is set by the writer, after a flush, to the flushRequestEpoch seen before the flush.
       };
+      //! The layout version of SharedMemObject, which is part of the shared memory name (see createShmName).
+      //! It must be incremented on each change of SharedMemObject (or its members) since processes of different
+      //! hdf5serie versions would otherwise misinterpret a shared memory left by the other version.
+      static constexpr int sharedMemObjectVersion { 2 };
+      // the status words are accessed by several processes: they must be address-free
+      static_assert(std::atomic<WriterState>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+                    "the shared memory status words must be lock-free");
 
       //! This callback is called when a writer requested a close of all readers
       const std::function<void()> closeRequestCallback;
@@ -243,8 +462,24 @@ namespace H5 {
       //! Pointer to the shared memory object
       SharedMemObject *sharedData {nullptr};
 
-      //! True if this reader has requested a flush.
-      bool flushRequested { false };
+      //! The flushDoneEpoch of the last writer flush this reader has been notified about.
+      uint32_t lastFlushDoneEpoch { 0 };
+      //! The minimal time between two flushes of a writer, see setMinFlushInterval.
+      std::chrono::milliseconds minFlushInterval { 0 };
+      //! The time of the last flush done by flushIfRequested of a writer.
+      std::chrono::steady_clock::time_point lastFlushTime;
+      //! The subscribed datasets of a reader and their subscription count, see subscribe
+      std::map<Dataset*, int> subscriptions;
+      //! If true refresh() refreshes only the subscribed datasets, see setRefreshSubscribedOnly
+      bool refreshSubscribedOnly { false };
+
+      //! The datasets modified since the last flush (may contain datasets which are already flushed by a full flush;
+      //! each dataset is contained only once, see Dataset::dirtyListed)
+      std::vector<Dataset*> dirtyDatasets;
+      //! Flush all datasets of dirtyDatasets (instead of walking the whole tree)
+      void flushDirtyDatasets();
+      //! Flush the file, call postFlushFunc and set flushDoneEpoch to requestEpoch and notify the readers.
+      void flushAndNotify(uint32_t requestEpoch, const std::function<void(File*)> &postFlushFunc);
       //! The last wrtierState known by this object.
       WriterState lastWriterState { WriterState::none };
 
@@ -261,7 +496,8 @@ namespace H5 {
       //! Helper function to prepare for openWriter
       void preOpenWriter();
       //! Helper function to open the file as a writer. preOpenWriter must be called before
-      void openWriter();
+      //! (the file is created except for reopen or a writeWithRename file after enableSWMR).
+      void openWriter(bool reopen=false);
       //! Helper function to close the file as a writer
       void closeWriter();
       void postCloseWriter();
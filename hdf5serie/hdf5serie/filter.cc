@@ -0,0 +1,257 @@
+/* Copyright (C) 2009 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+
+#include <config.h>
+#include "filter.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+using namespace std;
+using namespace fmatvec;
+
+namespace {
+
+  // transpose the 8x8 bit matrix x (byte r of x is row r)
+  inline uint64_t transpose8x8(uint64_t x) {
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+    return x;
+  }
+
+  // the default block size (number of elements) of the bitshuffle filter: about 8kB, a multiple of 8 elements
+  size_t defaultBlockSize(size_t typeSize) {
+    return max<size_t>(8192/typeSize/8*8, 128);
+  }
+
+  // The n elements (a multiple of 8) of one block are processed in groups of 8: for each byte b of the elements
+  // the 8x8 bit matrix formed by byte b of the 8 elements is transposed. Bit k of byte b of all elements is stored
+  // in bit plane b*8+k (each plane has n/8 bytes).
+  void bitshuffleBlock(const unsigned char *in, unsigned char *out, size_t n, size_t typeSize) {
+    size_t nrGroups=n/8;
+    for(size_t g=0; g<nrGroups; ++g)
+      for(size_t b=0; b<typeSize; ++b) {
+        uint64_t x=0;
+        for(size_t e=0; e<8; ++e)
+          x|=static_cast<uint64_t>(in[(g*8+e)*typeSize+b])<<(8*e);
+        x=transpose8x8(x);
+        for(size_t k=0; k<8; ++k)
+          out[(b*8+k)*nrGroups+g]=static_cast<unsigned char>(x>>(8*k));
+      }
+  }
+
+  void bitunshuffleBlock(const unsigned char *in, unsigned char *out, size_t n, size_t typeSize) {
+    size_t nrGroups=n/8;
+    for(size_t g=0; g<nrGroups; ++g)
+      for(size_t b=0; b<typeSize; ++b) {
+        uint64_t x=0;
+        for(size_t k=0; k<8; ++k)
+          x|=static_cast<uint64_t>(in[(b*8+k)*nrGroups+g])<<(8*k);
+        x=transpose8x8(x);
+        for(size_t e=0; e<8; ++e)
+          out[(g*8+e)*typeSize+b]=static_cast<unsigned char>(x>>(8*e));
+      }
+  }
+
+  // apply blockFunc to the blocks of blockSize elements like the bitshuffle filter does: the remaining elements
+  // are processed as a last smaller block rounded down to a multiple of 8, the elements after it are copied.
+  void blocked(void (*blockFunc)(const unsigned char*, unsigned char*, size_t, size_t),
+               const unsigned char *in, unsigned char *out, size_t n, size_t typeSize, size_t blockSize) {
+    if(blockSize==0)
+      blockSize=defaultBlockSize(typeSize);
+    size_t i=0;
+    for(; i+blockSize<=n; i+=blockSize)
+      blockFunc(in+i*typeSize, out+i*typeSize, blockSize, typeSize);
+    size_t last=(n-i)/8*8;
+    blockFunc(in+i*typeSize, out+i*typeSize, last, typeSize);
+    i+=last;
+    memcpy(out+i*typeSize, in+i*typeSize, (n-i)*typeSize);
+  }
+
+  // set_local callback of the bitshuffle filter: store the cd_values like the bitshuffle plugin does:
+  // the format version (0.4), the size of the datatype, the block size (0 = default) and the compression (0 = none)
+  herr_t bitshuffleSetLocal(hid_t dcpl, hid_t type, hid_t) {
+    unsigned int flags;
+    size_t nelmts=5;
+    unsigned int values[5]={0, 0, 0, 0, 0};
+    if(H5Pget_filter_by_id2(dcpl, H5::Internal::bitshuffleFilterID, &flags, &nelmts, values, 0, nullptr, nullptr)<0)
+      return -1;
+    values[0]=0;
+    values[1]=4;
+    values[2]=H5Tget_size(type);
+    if(values[2]==0 || values[3]%8!=0)
+      return -1;
+    if(H5Pmodify_filter(dcpl, H5::Internal::bitshuffleFilterID, flags, 5, values)<0)
+      return -1;
+    return 1;
+  }
+
+  // the filter function of the bitshuffle filter.
+  // Only the bitshuffle format without the LZ4 or Zstd compression of the bitshuffle plugin is supported.
+  size_t bitshuffleFilter(unsigned int flags, size_t cd_nelmts, const unsigned int cd_values[],
+                          size_t nbytes, size_t *buf_size, void **buf) {
+    if(cd_nelmts<3 || cd_values[2]==0 || (cd_nelmts>4 && cd_values[4]!=0))
+      return 0;
+    size_t typeSize=cd_values[2];
+    size_t blockSize=cd_nelmts>3 ? cd_values[3] : 0;
+    if(nbytes%typeSize!=0 || blockSize%8!=0)
+      return 0;
+    auto *out=static_cast<unsigned char*>(H5allocate_memory(nbytes, false));
+    if(!out)
+      return 0;
+    auto *in=static_cast<unsigned char*>(*buf);
+    if(flags & H5Z_FLAG_REVERSE)
+      H5::Internal::bitunshuffle(in, out, nbytes/typeSize, typeSize, blockSize);
+    else
+      H5::Internal::bitshuffle(in, out, nbytes/typeSize, typeSize, blockSize);
+    H5free_memory(*buf);
+    *buf=out;
+    *buf_size=nbytes;
+    return nbytes;
+  }
+
+  const H5Z_class2_t bitshuffleClass = {
+    H5Z_CLASS_T_VERS,               // version
+    H5::Internal::bitshuffleFilterID, // id
+    1, 1,                           // encoder and decoder present
+    "hdf5serie bitshuffle",         // name
+    nullptr,                        // can_apply
+    &bitshuffleSetLocal,            // set_local
+    &bitshuffleFilter,              // filter
+  };
+
+}
+
+namespace H5::Internal {
+
+  void registerFilters() {
+    static once_flag flag;
+    call_once(flag, [](){
+      // the bitshuffle plugin is used if available (it also supports its LZ4 and Zstd compressed format)
+      if(H5Zfilter_avail(bitshuffleFilterID)<=0)
+        checkCall(H5Zregister(&bitshuffleClass));
+    });
+  }
+
+  void setFilter(hid_t dcpl, Filter &filter, int compression, const string &path) {
+    if(filter==Filter::shuffleLZ4 || filter==Filter::shuffleZstd) {
+      auto id = filter==Filter::shuffleLZ4 ? lz4FilterID : zstdFilterID;
+      if(H5Zfilter_avail(id)<=0) {
+        Atom::msgStatic(Atom::Warn)<<"HDF5Serie: "<<path<<": The HDF5 filter plugin "<<(filter==Filter::shuffleLZ4 ? "LZ4" : "Zstd")
+                                   <<" is not available, using shuffle+deflate."<<endl;
+        filter=Filter::shuffleDeflate;
+      }
+    }
+    switch(filter) {
+      case Filter::deflate:
+        checkCall(H5Pset_deflate(dcpl, compression));
+        break;
+      case Filter::shuffleDeflate:
+        checkCall(H5Pset_shuffle(dcpl));
+        checkCall(H5Pset_deflate(dcpl, compression));
+        break;
+      case Filter::bitshuffleDeflate:
+        registerFilters();
+        checkCall(H5Pset_filter(dcpl, bitshuffleFilterID, H5Z_FLAG_MANDATORY, 0, nullptr));
+        checkCall(H5Pset_deflate(dcpl, compression));
+        break;
+      case Filter::shuffleLZ4:
+        checkCall(H5Pset_shuffle(dcpl));
+        checkCall(H5Pset_filter(dcpl, lz4FilterID, H5Z_FLAG_MANDATORY, 0, nullptr));
+        break;
+      case Filter::shuffleZstd: {
+        checkCall(H5Pset_shuffle(dcpl));
+        unsigned int level=compression;
+        checkCall(H5Pset_filter(dcpl, zstdFilterID, H5Z_FLAG_MANDATORY, 1, &level));
+        break;
+      }
+    }
+  }
+
+  bool getFilter(hid_t dcpl, Filter &filter, int &compression) {
+    filter=Filter::deflate;
+    compression=0;
+    bool shuffle=false;
+    bool bitshuffle=false;
+    int n=H5Pget_nfilters(dcpl);
+    checkCall(n);
+    for(int i=0; i<n; ++i) {
+      unsigned int flags;
+      size_t nelmts=5;
+      unsigned int values[5]={0, 0, 0, 0, 0};
+      auto id=H5Pget_filter2(dcpl, i, &flags, &nelmts, values, 0, nullptr, nullptr);
+      checkCall(id);
+      switch(id) {
+        case H5Z_FILTER_SHUFFLE:
+          shuffle=true;
+          break;
+        case bitshuffleFilterID:
+          // only the default block size without compression is written by hdf5serie itself
+          if(nelmts<3 || values[2]==0 || (nelmts>3 && values[3]!=0 && values[3]!=defaultBlockSize(values[2])) || (nelmts>4 && values[4]!=0))
+            return false;
+          bitshuffle=true;
+          break;
+        case H5Z_FILTER_DEFLATE:
+          filter=bitshuffle ? Filter::bitshuffleDeflate : (shuffle ? Filter::shuffleDeflate : Filter::deflate);
+          compression=values[0];
+          break;
+        case lz4FilterID:
+          filter=Filter::shuffleLZ4;
+          compression=1;
+          break;
+        case zstdFilterID:
+          filter=Filter::shuffleZstd;
+          compression=nelmts>0 ? values[0] : 1;
+          break;
+        default:
+          return false;
+      }
+    }
+    return true;
+  }
+
+  void shuffle(const unsigned char *in, unsigned char *out, size_t n, size_t typeSize) {
+    for(size_t i=0; i<n; ++i)
+      for(size_t b=0; b<typeSize; ++b)
+        out[b*n+i]=in[i*typeSize+b];
+  }
+
+  void unshuffle(const unsigned char *in, unsigned char *out, size_t n, size_t typeSize) {
+    for(size_t i=0; i<n; ++i)
+      for(size_t b=0; b<typeSize; ++b)
+        out[i*typeSize+b]=in[b*n+i];
+  }
+
+  void bitshuffle(const unsigned char *in, unsigned char *out, size_t n, size_t typeSize, size_t blockSize) {
+    blocked(&bitshuffleBlock, in, out, n, typeSize, blockSize);
+  }
+
+  void bitunshuffle(const unsigned char *in, unsigned char *out, size_t n, size_t typeSize, size_t blockSize) {
+    blocked(&bitunshuffleBlock, in, out, n, typeSize, blockSize);
+  }
+
+}
@@ -0,0 +1,60 @@
+/* Copyright (C) 2009 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+
+#ifndef _HDF5SERIE_FILTER_H_
+#define _HDF5SERIE_FILTER_H_
+
+#include <hdf5serie/options.h>
+#include <string>
+
+namespace H5::Internal {
+
+  //! The HDF5 filter id of the bitshuffle filter (registered by the HDF Group).
+  //! hdf5serie writes the format of the bitshuffle plugin without its own compression (deflate is added as the next filter).
+  //! The filter is registered by the File ctor if the bitshuffle plugin is not available.
+  constexpr H5Z_filter_t bitshuffleFilterID { 32008 };
+  //! The HDF5 filter ids of the LZ4 and Zstd filters (registered by the HDF Group, provided by HDF5 filter plugins)
+  constexpr H5Z_filter_t lz4FilterID { 32004 };
+  constexpr H5Z_filter_t zstdFilterID { 32015 };
+
+  //! Registers the filters of hdf5serie at the HDF5 library (only done once).
+  void registerFilters();
+
+  //! Adds the filter pipeline for filter with the compression level compression to the dataset creation property list dcpl.
+  //! If filter is not available filter is changed to the fallback filter and a warning is printed.
+  void setFilter(hid_t dcpl, Filter &filter, int compression, const std::string &path);
+
+  //! Detects the filter pipeline and the compression level of the dataset creation property list dcpl.
+  //! Returns false if dcpl contains filters not supported by Filter.
+  bool getFilter(hid_t dcpl, Filter &filter, int &compression);
+
+  //! Byte shuffle n elements of size typeSize from in to out (like the HDF5 shuffle filter).
+  void shuffle(const unsigned char *in, unsigned char *out, size_t n, size_t typeSize);
+  void unshuffle(const unsigned char *in, unsigned char *out, size_t n, size_t typeSize);
+  //! Bit shuffle n elements of size typeSize from in to out in blocks of blockSize elements (0 = default)
+  //! (like the bitshuffle filter).
+  void bitshuffle(const unsigned char *in, unsigned char *out, size_t n, size_t typeSize, size_t blockSize=0);
+  void bitunshuffle(const unsigned char *in, unsigned char *out, size_t n, size_t typeSize, size_t blockSize=0);
+
+}
+
+#endif
@@ -174,6 +174,11 @@ void GroupBase::enableSWMR() {
   Container<Object, GroupBase>::enableSWMR();
 }
 
+void GroupBase::reopen() {
+  Object::reopen();
+  Container<Object, GroupBase>::reopen();
+}
+
 GroupBase *GroupBase::getFileAsGroup() {
   return getFile();
 }
@@ -211,4 +216,9 @@ void Group::enableSWMR() {
   GroupBase::enableSWMR();
 }
 
+void Group::reopen() {
+  id.reset(H5Gopen2(parent->getID(), name.c_str(), H5P_DEFAULT), &H5Gclose);
+  GroupBase::reopen();
+}
+
 }
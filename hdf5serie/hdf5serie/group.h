@@ -36,6 +36,7 @@ namespace H5 {
       void close() override;
       void refresh() override;
       void enableSWMR() override;
+      void reopen() override;
       Dataset *openChildDataset(const std::string &name_, ElementType *objectType, ScopedHID *type);
       GroupBase *getFileAsGroup();
     public:
@@ -85,6 +86,7 @@ namespace H5 {
       void refresh() override;
       void flush() override;
       void enableSWMR() override;
+      void reopen() override;
   };
 
 }
@@ -32,7 +32,8 @@
 using namespace std;
 
 namespace {
-  vector<H5::ErrorInfo> globalErrorStack;
+  // the HDF5 error stack is per thread (for a thread-safe HDF5 build) -> collect the errors per thread
+  thread_local vector<H5::ErrorInfo> globalErrorStack;
 
   herr_t getChildNamesACB(hid_t, const char *name, const H5A_info_t *, void *op_data) {
     pair<exception_ptr, set<string>> &ret=*static_cast<pair<exception_ptr, set<string>>*>(op_data);
@@ -117,15 +118,19 @@ const char* Exception::what() const noexcept {
   return whatMsg.c_str();
 }
 
-Element::Element(std::string name_) :  name(std::move(name_)) {
+void installErrorHandler() {
   // print errors as exceptions
-  static bool firstCall=true;
+  thread_local bool firstCall=true;
   if(firstCall) {
     checkCall(H5Eset_auto2(H5E_DEFAULT, &errorHandler, &globalErrorStack));
     firstCall=false;
   }
 }
 
+Element::Element(std::string name_) :  name(std::move(name_)) {
+  installErrorHandler();
+}
+
 Element::~Element() = default;
 
 void Element::refresh() {
@@ -140,6 +145,9 @@ void Element::flush() {
 void Element::enableSWMR() {
 }
 
+void Element::reopen() {
+}
+
 Object::Object(GroupBase *parent_, const std::string &name_) : Element(name_), 
   parent(parent_), file(parent?parent->file:nullptr) { // parent is NULL only for File which sets file by itself
 }
@@ -243,6 +251,12 @@ void Object::close() {
   Element::close();
 }
 
+void Object::reopen() {
+  // the id of this object is reopened by the derived class before its attributes
+  Element::reopen();
+  Container<Attribute, Object>::reopen();
+}
+
 Object *Object::getFileAsObject() {
   return getFile();
 }
@@ -294,6 +308,16 @@ void Dataset::refresh() {
 void Dataset::flush() {
   Object::flush();
   checkCall(H5Dflush(id));
+  dirty=false;
+}
+
+void Dataset::setDirty() {
+  dirty=true;
+  // a dataset flushed by a full flush is still in the list: add it only once
+  if(!dirtyListed) {
+    dirtyListed=true;
+    file->addDirtyDataset(this);
+  }
 }
 
 void Dataset::enableSWMR() {
@@ -302,6 +326,8 @@ void Dataset::enableSWMR() {
 
 void Dataset::close() {
   Object::close();
+  dirty=false;
+  dirtyListed=false; // the file clears its list on close
 }
 
 vector<hsize_t> Dataset::getExtentDims() {
@@ -40,6 +40,7 @@ namespace H5 {
   // - enableSWMR: for type=write: closes all attributes than switches File to SWMR writing mode
   //               for type=writeWithRename: closes all elements, rename the file, reopen all elements
   //                                         except attributes, then switches File to SWMR writing mode
+  // - reopen: reopens all HDF5 handles closed by close (used by File to reopen the file with chunk alignment)
 
   struct ErrorInfo {
     ErrorInfo(hid_t cls_id_, hid_t maj_num_, hid_t min_num_, unsigned line_,
@@ -138,6 +139,10 @@ namespace H5 {
       throw Exception({}, "A call to a HDF5 function failed.");
   }
 
+  //! Install the error handler which converts HDF5 errors to Exception's for the calling thread.
+  //! This is done automatically by the ctor of Element but must be called by any other thread calling HDF5 functions.
+  void installErrorHandler();
+
   class File;
   class GroupBase;
   class Attribute;
@@ -166,8 +171,10 @@ namespace H5 {
       virtual void refresh();
       virtual void flush();
       virtual void enableSWMR();
+      virtual void reopen();
     public:
-      //! Note: use the returned hid_t only temporarily since it may get invalid, at least when File::enableSWMR is called.
+      //! Note: use the returned hid_t only temporarily since it may get invalid, at least when File::enableSWMR is called
+      //! or when the first dataset with Options::alignChunks is created.
       hid_t getID() { return id; }
       std::string getName() { return name; }
   };
@@ -181,9 +188,11 @@ namespace H5 {
         for(auto it=childs.begin(); it!=childs.end(); ++it)
           delete it->second;
       }
+      // close, flush and reopen skip a child which is currently created (nullptr, see Creator): its ctor may reopen the file
       void close() {
         for(auto it=childs.begin(); it!=childs.end(); ++it)
-          it->second->close();
+          if(it->second)
+            it->second->close();
       }
       void refresh() {
         for(auto it=childs.begin(); it!=childs.end(); ++it)
@@ -191,7 +200,13 @@ namespace H5 {
       }
       void flush() {
         for(auto it=childs.begin(); it!=childs.end(); ++it)
-          it->second->flush();
+          if(it->second)
+            it->second->flush();
+      }
+      void reopen() {
+        for(auto it=childs.begin(); it!=childs.end(); ++it)
+          if(it->second)
+            it->second->reopen();
       }
       void enableSWMR() {
         if constexpr (std::is_same_v<Child, Attribute>) {
@@ -276,6 +291,7 @@ namespace H5 {
       void refresh() override;
       void flush() override;
       void enableSWMR() override;
+      void reopen() override;
       GroupBase *parent;
       File *file;
       Object *getFileAsObject(); // helper function used in openChildAttribute
@@ -329,6 +345,7 @@ namespace H5 {
   };
 
   class Dataset : public Object {
+    friend class File; // to allow File::refresh to refresh only the subscribed datasets
     protected:
       Dataset(GroupBase *parent_, const std::string &name_);
       Dataset(int dummy, GroupBase *parent_, const std::string &name_);
@@ -339,6 +356,15 @@ namespace H5 {
     public:
       void flush() override;
       std::vector<hsize_t> getExtentDims();
+      //! Mark this dataset as modified: only modified datasets are flushed by flushIfRequested of the file.
+      //! Called by all functions which write data to the dataset.
+      void markDirty() { if(!dirty) setDirty(); }
+      //! Returns true if the dataset was modified since its last flush.
+      bool isDirty() const { return dirty; }
+    private:
+      bool dirty { false };
+      bool dirtyListed { false }; // true if this dataset is in the list of modified datasets of the file
+      void setDirty();
   };
 
 }
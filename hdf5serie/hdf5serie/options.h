@@ -26,15 +26,56 @@
 
 namespace H5 {
 
+  //! The filter pipeline used to compress a dataset (if the compression level is >0)
+  enum class Filter {
+    deflate,           //!< deflate with the compression level
+    shuffleDeflate,    //!< byte shuffle + deflate with the compression level
+    bitshuffleDeflate, //!< bit shuffle (the bitshuffle filter 32008, readable with the bitshuffle plugin) + deflate with the compression level
+    shuffleLZ4,        //!< byte shuffle + LZ4 (needs the HDF5 LZ4 filter plugin, falls back to shuffleDeflate if not available)
+    shuffleZstd,       //!< byte shuffle + Zstd with the compression level (needs the HDF5 Zstd filter plugin, falls back to shuffleDeflate if not available)
+  };
+
   struct Options {
     int fixedStrSize = -1;
     int compression = File::getDefaultCompression();
+    Filter filter = Filter::deflate;
     int chunkSize = File::getDefaultChunkSize();
+    // number of columns of a chunk (0 = all columns). Use a small value (e.g. 1) if single columns of datasets
+    // with many columns are read frequently (e.g. by h5plotserie): only the chunks of the column need to be read then.
+    int chunkColumns = 0;
     int cacheSize = File::getDefaultCacheSize();
+    bool asyncWrite = File::getDefaultAsyncWrite(); // write filled cache blocks by the writer thread of the file (only used if cacheSize>1)
+    int cacheBlocks = 2; // number of cache blocks (each of cacheSize rows) used as a ring if asyncWrite is set
+    // grow the extent of the dataset geometrically instead of on each write to reduce HDF5 metadata operations.
+    // The extent is trimmed to the written rows on close. The number of flushed rows is stored in the dataset
+    // <name>.rows (see rowsDatasetSuffix): readers see only these rows (VectorSerie::getRows).
+    bool reserveExtent = false;
+    // set cacheSize to chunkSize and write full cache blocks as chunks using H5Dwrite_chunk (compressed by hdf5serie itself)
+    // which bypasses the HDF5 filter pipeline and chunk cache. Not used for std::string datasets and the LZ4 and Zstd filters.
+    // Implies alignChunks.
+    bool directChunkWrite = false;
+    // align the chunks to 16 bytes in the file: needed by the zero-copy reads of VectorSerie::mapChunk.
+    // HDF5 can align allocations only for the whole file: when the first such dataset is created the writer reopens the file
+    // with alignment, all larger allocations (of all datasets) made after it are aligned.
+    bool alignChunks = false;
+    // number of levels of the summary pyramid written to the group <name>.summary (0 = none, see VectorSerie).
+    // Level l holds the min, max and mean of each column for each block of summaryBlockRows*2^l rows.
+    // Only used for datasets of real number types.
+    int summaryLevels = 0;
+    int summaryBlockRows = 256;
     Options& _fixedStrSize(int v) { fixedStrSize = v; return *this; }
     Options& _compression(int v) { compression = v; return *this; }
+    Options& _filter(Filter v) { filter = v; return *this; }
     Options& _chunkSize(int v) { chunkSize = v; return *this; }
+    Options& _chunkColumns(int v) { chunkColumns = v; return *this; }
     Options& _cacheSize(int v) { cacheSize = v; return *this; }
+    Options& _asyncWrite(bool v) { asyncWrite = v; return *this; }
+    Options& _cacheBlocks(int v) { cacheBlocks = v; return *this; }
+    Options& _reserveExtent(bool v) { reserveExtent = v; return *this; }
+    Options& _directChunkWrite(bool v) { directChunkWrite = v; return *this; }
+    Options& _alignChunks(bool v) { alignChunks = v; return *this; }
+    Options& _summaryLevels(int v) { summaryLevels = v; return *this; }
+    Options& _summaryBlockRows(int v) { summaryBlockRows = v; return *this; }
   };
 
 }
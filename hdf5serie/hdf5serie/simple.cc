@@ -1,3 +1,31 @@
+#ifdef HDF5SERIE_DATASETTYPE
+namespace {
+  // read the nrElements elements of the selection fileSpaceID of the dataset id to data (stored as given by memSpaceID)
+  template<class T>
+  void readSelection(hid_t id, hid_t memDataTypeID, hid_t memSpaceID, hid_t fileSpaceID, size_t nrElements, T *data) {
+    if constexpr (is_same_v<T, string>) {
+      if(H5Tis_variable_str(memDataTypeID)) {
+        VecStr buf(nrElements);
+        checkCall(H5Dread(id, memDataTypeID, memSpaceID, fileSpaceID, H5P_DEFAULT, &buf[0]));
+        for(size_t i=0; i<nrElements; i++)
+          data[i]=buf[i];
+      }
+      else {
+        auto fixedStrSize=H5Tget_size(memDataTypeID);
+        vector<char> buf(fixedStrSize*nrElements);
+        checkCall(H5Dread(id, memDataTypeID, memSpaceID, fileSpaceID, H5P_DEFAULT, &buf[0]));
+        for(size_t i=0; i<nrElements; i++) {
+          char *start=&buf[i*fixedStrSize];
+          data[i]=string(start, strnlen(start, fixedStrSize));
+        }
+      }
+    }
+    else
+      checkCall(H5Dread(id, memDataTypeID, memSpaceID, fileSpaceID, H5P_DEFAULT, data));
+  }
+}
+#endif
+
 // open
 template<class T>
 HDF5SERIE_CLASS<T>::HDF5SERIE_CLASS(int dummy, HDF5SERIE_PARENTCLASS *parent_, const std::string& name_) : HDF5SERIE_BASECLASS(parent_, name_) {
@@ -34,6 +62,12 @@ void HDF5SERIE_CLASS<T>::enableSWMR() {
   HDF5SERIE_BASECLASS::enableSWMR();
 }
 
+template<class T>
+void HDF5SERIE_CLASS<T>::reopen() {
+  id.reset(HDF5SERIE_H5XOPEN, &HDF5SERIE_H5XCLOSE);
+  HDF5SERIE_BASECLASS::reopen();
+}
+
 template<class T>
 void HDF5SERIE_CLASS<T>::write(const T& data) {
   checkCall(HDF5SERIE_H5XWRITE(&data));
@@ -120,6 +154,12 @@ void HDF5SERIE_CLASS<vector<T> >::enableSWMR() {
   HDF5SERIE_BASECLASS::enableSWMR();
 }
 
+template<class T>
+void HDF5SERIE_CLASS<vector<T> >::reopen() {
+  id.reset(HDF5SERIE_H5XOPEN, &HDF5SERIE_H5XCLOSE);
+  HDF5SERIE_BASECLASS::reopen();
+}
+
 template<class T>
 void HDF5SERIE_CLASS<vector<T> >::write(const vector<T> &data) {
   if(static_cast<int>(data.size())!=size)
@@ -177,6 +217,25 @@ vector<string> HDF5SERIE_CLASS<vector<string> >::read() {
   return data;
 }
 
+#ifdef HDF5SERIE_DATASETTYPE
+template<class T>
+vector<T> HDF5SERIE_CLASS<vector<T> >::read(int first, int count) {
+  if(first<0 || count<0 || first+count>size)
+    throw Exception(getPath(), "Requested elements ["+to_string(first)+".."+to_string(first+count)+"[ are out of range [0.."+
+                               to_string(size)+"[");
+  vector<T> ret(count);
+  if(count==0)
+    return ret;
+  hsize_t start[]={static_cast<hsize_t>(first)};
+  hsize_t n[]={static_cast<hsize_t>(count)};
+  ScopedHID fileSpaceID(H5Scopy(memDataSpaceID), &H5Sclose);
+  checkCall(H5Sselect_hyperslab(fileSpaceID, H5S_SELECT_SET, start, nullptr, n, nullptr));
+  ScopedHID memSpaceID(H5Screate_simple(1, n, nullptr), &H5Sclose);
+  readSelection(id, memDataTypeID, memSpaceID, fileSpaceID, count, ret.data());
+  return ret;
+}
+#endif
+
 # define FOREACHKNOWNTYPE(CTYPE, H5TYPE) \
   template class HDF5SERIE_CLASS<vector<CTYPE> >;
 # include "knowntypes.def"
@@ -243,6 +302,12 @@ void HDF5SERIE_CLASS<vector<vector<T> > >::enableSWMR() {
   HDF5SERIE_BASECLASS::enableSWMR();
 }
 
+template<class T>
+void HDF5SERIE_CLASS<vector<vector<T> > >::reopen() {
+  id.reset(HDF5SERIE_H5XOPEN, &HDF5SERIE_H5XCLOSE);
+  HDF5SERIE_BASECLASS::reopen();
+}
+
 template<class T>
 void HDF5SERIE_CLASS<vector<vector<T> > >::write(const vector<vector<T> > &data) {
   if(static_cast<int>(data.size())!=rows || static_cast<int>(data[0].size())!=cols)
@@ -324,6 +389,28 @@ vector<vector<string> > HDF5SERIE_CLASS<vector<vector<string> > >::read() {
   return ret;
 }
 
+#ifdef HDF5SERIE_DATASETTYPE
+template<class T>
+vector<vector<T> > HDF5SERIE_CLASS<vector<vector<T> > >::readRows(int firstRow, int nrRows) {
+  if(firstRow<0 || nrRows<0 || firstRow+nrRows>rows)
+    throw Exception(getPath(), "Requested rows ["+to_string(firstRow)+".."+to_string(firstRow+nrRows)+"[ are out of range [0.."+
+                               to_string(rows)+"[");
+  vector<vector<T> > ret(nrRows);
+  if(nrRows==0)
+    return ret;
+  hsize_t start[]={static_cast<hsize_t>(firstRow), 0};
+  hsize_t count[]={static_cast<hsize_t>(nrRows), static_cast<hsize_t>(cols)};
+  ScopedHID fileSpaceID(H5Scopy(memDataSpaceID), &H5Sclose);
+  checkCall(H5Sselect_hyperslab(fileSpaceID, H5S_SELECT_SET, start, nullptr, count, nullptr));
+  ScopedHID memSpaceID(H5Screate_simple(2, count, nullptr), &H5Sclose);
+  vector<T> buf(nrRows*cols);
+  readSelection(id, memDataTypeID, memSpaceID, fileSpaceID, buf.size(), buf.data());
+  for(int r=0; r<nrRows; ++r)
+    ret[r].assign(make_move_iterator(buf.begin()+r*cols), make_move_iterator(buf.begin()+(r+1)*cols));
+  return ret;
+}
+#endif
+
 # define FOREACHKNOWNTYPE(CTYPE, H5TYPE) \
   template class HDF5SERIE_CLASS<vector<vector<CTYPE> > >;
 # include "knowntypes.def"
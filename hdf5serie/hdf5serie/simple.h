@@ -53,6 +53,7 @@ class HDF5SERIE_CLASS : public HDF5SERIE_BASECLASS {
     void close() override;
 
     void enableSWMR() override;
+    void reopen() override;
 
   public:
     /** \brief Write data
@@ -92,10 +93,16 @@ class HDF5SERIE_CLASS<std::vector<T> > : public HDF5SERIE_BASECLASS {
     ~HDF5SERIE_CLASS() override;
     void close() override;
     void enableSWMR() override;
+    void reopen() override;
   public:
     void write(const std::vector<T>& data);
     std::vector<T> read();
     #ifdef HDF5SERIE_DATASETTYPE
+      /** \brief Read the elements [\a first, \a first+\a count[
+       *
+       * Only these elements are read from the file (see read() to read all elements).
+       */
+      std::vector<T> read(int first, int count);
       void setDescription(const std::string &desc) {
         SimpleAttribute<std::string> *a=createChildAttribute<SimpleAttribute<std::string> >("Description")();
         a->write(desc);
@@ -121,10 +128,20 @@ class HDF5SERIE_CLASS<std::vector<std::vector<T> > > : public HDF5SERIE_BASECLAS
     ~HDF5SERIE_CLASS() override;
     void close() override;
     void enableSWMR() override;
+    void reopen() override;
   public:
     void write(const std::vector<std::vector<T> >& data);
     std::vector<std::vector<T> > read();
     #ifdef HDF5SERIE_DATASETTYPE
+      /** \brief Read the rows [\a firstRow, \a firstRow+\a nrRows[
+       *
+       * Only these rows are read from the file (see read() to read the full matrix).
+       */
+      std::vector<std::vector<T> > readRows(int firstRow, int nrRows);
+      /** \brief Read the row \a row */
+      std::vector<T> readRow(int row) {
+        return std::move(readRows(row, 1)[0]);
+      }
       void setDescription(const std::string &desc) {
         SimpleAttribute<std::string> *a=createChildAttribute<SimpleAttribute<std::string> >("Description")();
         a->write(desc);
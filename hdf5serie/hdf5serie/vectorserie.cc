@@ -23,11 +23,15 @@
 #include <hdf5serie/vectorserie.h>
 #include <hdf5serie/simpleattribute.h>
 #include <hdf5serie/toh5type.h>
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
+#include <zlib.h>
 #include "utils.h"
+#include "filter.h"
 
 using namespace std;
 
@@ -65,16 +69,39 @@ namespace H5 {
       throw Exception(getPath(), "A VectorSerie dataset must have unlimited dimension in the first dimension.");
     ScopedHID cpl(H5Dget_create_plist(id), &H5Pclose);
     checkCall(H5Pget_chunk(cpl, 2, maxDims));
+    if(!Internal::getFilter(cpl, filter, compression))
+      directChunkWrite=false; // unknown filters: we cannot compress chunks ourself
+    chunkRows=maxDims[0];
+    chunkColumns=maxDims[1];
     ScopedHID apl(H5Dget_access_plist(id), &H5Pclose);
     id.reset();
-    // reopen the dataset with chunk cache == chunk size
-    checkCall(H5Pset_chunk_cache(apl, 521, sizeof(T)*dims[1]*maxDims[0], 0.75));
+    // reopen the dataset with chunk cache == size of all chunks of a chunk row
+    setChunkCache(apl, maxDims[0]);
     id.reset(H5Dopen(parent->getID(), name.c_str(), apl), &H5Dclose);
     fileDataSpaceID.reset(H5Dget_space(id), &H5Sclose);
+    extent=dims[0];
+    string rowsName=name+rowsDatasetSuffix;
+    if(H5Lexists(parent->getID(), rowsName.c_str(), H5P_DEFAULT)>0) {
+      rowsID.reset(H5Dopen(parent->getID(), rowsName.c_str(), H5P_DEFAULT), &H5Dclose);
+      if(file->getType()==File::read)
+        readRowCount();
+    }
+  }
+
+  template<class T>
+  void VectorSerie<T>::setChunkCache(hid_t apl, hsize_t chunkRows) {
+    // the cache must hold all chunks of a chunk row (a full cache block is written to all of them)
+    hsize_t cols=max<hsize_t>(chunkColumns, 1);
+    hsize_t nrChunks=(dims[1]+cols-1)/cols;
+    checkCall(H5Pset_chunk_cache(apl, max<hsize_t>(521, 10*nrChunks+1), sizeof(T)*nrChunks*cols*chunkRows, 0.75));
   }
 
   template<class T>
   VectorSerie<T>::VectorSerie(GroupBase *parent_, const string &name_, int cols, const Options &opts) : Dataset(parent_, name_) {
+    // before this dataset is created: the file may get reopened
+    if(opts.alignChunks || opts.directChunkWrite)
+      file->enableChunkAlignment();
+
     if constexpr(is_same_v<T, string>) {
       if(opts.fixedStrSize<0)
         memDataTypeID.reset(H5Tcopy(toH5Type<T>()), &H5Tclose);
@@ -94,11 +121,16 @@ namespace H5 {
     fileDataSpaceID.reset(H5Screate_simple(2, dims, maxDims), &H5Sclose);
     ScopedHID propID(H5Pcreate(H5P_DATASET_CREATE), &H5Pclose);
     checkCall(H5Pset_attr_phase_change(propID, 0, 0));
-    hsize_t chunkDims[]={(hsize_t)opts.chunkSize, (hsize_t)(dims[1])};
+    chunkColumns=opts.chunkColumns>0 ? min<hsize_t>(opts.chunkColumns, dims[1]) : dims[1];
+    chunkRows=opts.chunkSize;
+    hsize_t chunkDims[]={chunkRows, chunkColumns};
     checkCall(H5Pset_chunk(propID, 2, chunkDims));
-    if(opts.compression>0) checkCall(H5Pset_deflate(propID, opts.compression));
+    if(opts.compression>0) {
+      filter=opts.filter;
+      Internal::setFilter(propID, filter, opts.compression, getPath());
+    }
     ScopedHID apl(H5Pcreate(H5P_DATASET_ACCESS), &H5Pclose);
-    checkCall(H5Pset_chunk_cache(apl, 521, sizeof(T)*dims[1]*opts.chunkSize, 0.75));
+    setChunkCache(apl, opts.chunkSize);
     id.reset(H5Dcreate2(parent->getID(), name.c_str(), memDataTypeID,
                        fileDataSpaceID, H5P_DEFAULT, propID, apl), &H5Dclose);
 
@@ -108,17 +140,42 @@ namespace H5 {
 
     hsize_t memDims[]={1, dims[1]};
     memDataSpaceID.reset(H5Screate_simple(2, memDims, nullptr), &H5Sclose);
-    if(opts.cacheSize>1) {
+    reserveExtent=opts.reserveExtent;
+    int cacheSize=opts.cacheSize;
+#if H5_VERSION_GE(1, 10, 3)
+    if constexpr (!is_same_v<T, string>)
+      if(opts.directChunkWrite && opts.chunkSize>1 &&
+         (opts.compression<=0 || filter==Filter::deflate || filter==Filter::shuffleDeflate || filter==Filter::bitshuffleDeflate)) {
+        // a cache block is exactly one chunk
+        directChunkWrite=true;
+        compression=opts.compression;
+        cacheSize=opts.chunkSize;
+      }
+#endif
+    if(cacheSize>1) {
+      asyncWrite=opts.asyncWrite;
+      int blocks=asyncWrite ? max(opts.cacheBlocks, 1) : 1;
       if constexpr (is_same_v<T, string>) {
         if(opts.fixedStrSize>0)
-          cacheFixedSizeStr.resize(boost::extents[opts.cacheSize][cols][opts.fixedStrSize]);
+          cacheFixedSizeStr.resize(boost::extents[blocks][cacheSize][cols][opts.fixedStrSize]);
       }
       else
-        cache.resize(boost::extents[opts.cacheSize][cols]);
-      cacheRow=0;
-      memDims[0]=opts.cacheSize;
+        cache.resize(boost::extents[blocks][cacheSize][cols]);
+      memDims[0]=cacheSize;
       memDataSpaceCacheID.reset(H5Screate_simple(2, memDims, nullptr), &H5Sclose);
     }
+    if(reserveExtent) {
+      // readers cannot distinguish reserved from written rows: store the number of written rows in <name>.rows
+      hsize_t one[]={1};
+      ScopedHID space(H5Screate_simple(1, one, one), &H5Sclose);
+      ScopedHID rowsPropID(H5Pcreate(H5P_DATASET_CREATE), &H5Pclose);
+      checkCall(H5Pset_chunk(rowsPropID, 1, one));
+      rowsID.reset(H5Dcreate2(parent->getID(), (name+rowsDatasetSuffix).c_str(), H5T_NATIVE_INT, space, H5P_DEFAULT, rowsPropID, H5P_DEFAULT),
+                   &H5Dclose);
+      writeRowCount();
+    }
+    if(opts.summaryLevels>0)
+      createSummary(opts);
     msg(Debug)<<"HDF5:"<<endl
               <<"Created object with name = "<<name<<", id = "<<id<<" at parent with id = "<<parent->getID()<<"."<<endl;
   }
@@ -128,16 +185,22 @@ namespace H5 {
 
   template<class T>
   void VectorSerie<T>::close() {
-    if constexpr (!is_same_v<T, string>)
-      if(int cacheSize=cache.shape()[0]; cacheSize>1 && cacheRow>0) {
-        writeToHDF5(cacheRow, cacheSize, cache.data());
-        cacheRow=0;
-      }
-    if constexpr (is_same_v<T, string>)
-      if(int cacheSize=cacheFixedSizeStr.shape()[0]; cacheSize>1 && cacheRow>0) {
-        writeToHDF5(cacheRow, cacheSize, cacheFixedSizeStr.data());
-        cacheRow=0;
-      }
+    if(!file->reopening)
+      slotPending=false; // the row returned by appendSlot must be filled before close
+    flushCache();
+    waitForAsyncWrite();
+    trimExtent();
+    if(rowsID>=0 && file->getType()!=File::read)
+      writeRowCount();
+    rowsID.reset();
+    rowCount=-1;
+    for(auto &level : summary)
+      level.id.reset();
+    mappedRegion=boost::interprocess::mapped_region();
+    fileMapping=boost::interprocess::file_mapping();
+    mappable=-1;
+    if(file->getType()==File::read)
+      file->getChunkCache().erase(this);
 
     Dataset::close();
     // memDataSpaceID.reset(); do not close this since its not file related (to avoid the need for reopen it in writetemp mode)
@@ -149,22 +212,29 @@ namespace H5 {
   void VectorSerie<T>::refresh() {
     Dataset::refresh();
     fileDataSpaceID.reset(H5Dget_space(id), &H5Sclose);
+    if(rowsID>=0) {
+      checkCall(H5Drefresh(rowsID));
+      readRowCount();
+    }
+    // the cached chunk rows may contain rows which were not written at the time they were read
+    // (e.g. the fill values of an extent reserved by the writer): read them again
+    if(file->getType()==File::read)
+      file->getChunkCache().erase(this);
   }
 
   template<class T>
   void VectorSerie<T>::flush() {
-    if constexpr (!is_same_v<T, string>)
-      if(int cacheSize=cache.shape()[0]; cacheSize>1 && cacheRow>0) {
-        writeToHDF5(cacheRow, cacheSize, cache.data());
-        cacheRow=0;
-      }
-    if constexpr (is_same_v<T, string>)
-      if(int cacheSize=cacheFixedSizeStr.shape()[0]; cacheSize>1 && cacheRow>0) {
-        writeToHDF5(cacheRow, cacheSize, cacheFixedSizeStr.data());
-        cacheRow=0;
-      }
+    flushCache();
+    waitForAsyncWrite();
+    rowsSinceFlush=0;
+    // the summary datasets are written together with the dataset: flush them for SWMR readers too
+    for(auto &level : summary)
+      checkCall(H5Dflush(level.id));
 
     Dataset::flush();
+    // the reserved extent is kept (it is trimmed by close): the number of written rows is stored after the rows are flushed
+    if(rowsID>=0)
+      writeRowCount();
   }
 
   template<class T>
@@ -174,10 +244,216 @@ namespace H5 {
   }
 
   template<class T>
-  void VectorSerie<T>::writeToHDF5(size_t nrRows, size_t cacheSize, const std::conditional_t<std::is_same_v<T,std::string>,char,T>* data) {
-    dims[0]+=nrRows;
+  size_t VectorSerie<T>::getCacheSize() const {
+    if constexpr (is_same_v<T, string>)
+      return cacheFixedSizeStr.shape()[1];
+    else
+      return cache.shape()[1];
+  }
+
+  template<class T>
+  auto VectorSerie<T>::getCacheBlock() -> CacheType* {
+    if constexpr (is_same_v<T, string>)
+      return cacheFixedSizeStr[cacheBlock].origin();
+    else
+      return cache[cacheBlock].origin();
+  }
+
+  template<class T>
+  void VectorSerie<T>::flushCache() {
+    // flushedCacheRows is reset by the writer thread when it writes the full chunk: wait for it before using it
+    if(directChunkWrite)
+      waitForAsyncWrite();
+    // the last row returned by appendSlot may not be filled yet: do not write it (it is written by a later write)
+    size_t rows=slotPending ? cacheRow-1 : cacheRow;
+    if(rows<=flushedCacheRows)
+      return;
+    if(directChunkWrite) {
+      // write the partial chunk but keep the rows in the cache: the chunk is rewritten when the cache block is full
+      writeToHDF5(rows, getCacheSize(), getCacheBlock());
+      if(rows>=getCacheSize())
+        cacheRow=0;
+    }
+    else if(slotPending) {
+      // write the filled rows but keep them in the cache block (writeCache skips them when the block is written)
+      waitForAsyncWrite();
+      writeToHDF5(rows-flushedCacheRows, getCacheSize(), &getCacheBlock()[flushedCacheRows*dims[1]]);
+      flushedCacheRows=rows;
+    }
+    else {
+      writeCache(cacheRow);
+      cacheRow=0;
+    }
+  }
+
+  template<class T>
+  void VectorSerie<T>::writeCache(size_t nrRows) {
+    const CacheType *data=getCacheBlock();
+    size_t blocks=is_same_v<T, string> ? cacheFixedSizeStr.shape()[0] : cache.shape()[0];
+    auto cacheSize=getCacheSize();
+    if(!directChunkWrite && flushedCacheRows>0) {
+      // the first rows of the block were already written by flushCache while an appendSlot row was pending
+      data+=flushedCacheRows*dims[1];
+      nrRows-=flushedCacheRows;
+      flushedCacheRows=0;
+    }
+
+    if(asyncWrite)
+      if(auto *asyncWriter=file->getAsyncWriter(); asyncWriter) {
+        // let the writer thread write the cache block (no copy) ...
+        if(directChunkWrite && compression>0 && nrRows==cacheSize) {
+          // ... but compress the chunk first by the compression thread pool (in parallel with the chunks of other datasets).
+          // The writer thread writes the chunks in order when compressed.
+          auto chunks=Internal::ThreadPool::getCompressionPool().submit([this, cacheSize, data]() {
+            vector<vector<unsigned char>> chunks((dims[1]+chunkColumns-1)/chunkColumns);
+            for(size_t colGroup=0; colGroup<chunks.size(); ++colGroup)
+              encodeChunk(data, cacheSize, colGroup, chunks[colGroup]);
+            return chunks;
+          });
+          asyncWriter->push([this, cacheSize, chunks, data]() {
+            try {
+              writeEncodedChunksToHDF5(cacheSize, chunks.get(), data);
+            }
+            catch(...) {
+              writtenBlocks++;
+              throw;
+            }
+            writtenBlocks++;
+          });
+        }
+        else
+          asyncWriter->push([this, nrRows, cacheSize, data]() {
+            try {
+              writeToHDF5(nrRows, cacheSize, data);
+            }
+            catch(...) {
+              writtenBlocks++;
+              throw;
+            }
+            writtenBlocks++;
+          });
+        submittedBlocks++;
+        // ... and continue with the next block of the ring which must have been written already
+        cacheBlock=(cacheBlock+1)%blocks;
+        asyncWriter->wait([this, blocks](){ return submittedBlocks-writtenBlocks<blocks; });
+        return;
+      }
+    writeToHDF5(nrRows, cacheSize, data);
+  }
+
+  template<class T>
+  void VectorSerie<T>::waitForAsyncWrite() {
+    if(submittedBlocks==writtenBlocks)
+      return;
+    file->getAsyncWriter()->wait([this](){ return submittedBlocks==writtenBlocks; });
+  }
+
+  template<class T>
+  void VectorSerie<T>::trimExtent() {
+    if(extent<=dims[0])
+      return;
+    extent=dims[0];
     checkCall(H5Dset_extent(id, dims)); // this invalidates fileDataSpaceID -> get it again
     fileDataSpaceID.reset(H5Dget_space(id), &H5Sclose);
+  }
+
+  template<class T>
+  void VectorSerie<T>::writeRowCount() {
+    int rows=dims[0];
+    checkCall(H5Dwrite(rowsID, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &rows));
+    checkCall(H5Dflush(rowsID));
+  }
+
+  template<class T>
+  void VectorSerie<T>::readRowCount() {
+    checkCall(H5Dread(rowsID, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &rowCount));
+  }
+
+  template<class T>
+  void VectorSerie<T>::growExtent(size_t nrRows) {
+    dims[0]+=nrRows;
+    if(dims[0]>extent) {
+      // grow the extent to the written rows or, if reserveExtent is set, geometrically
+      extent=reserveExtent ? max(dims[0], 2*extent) : dims[0];
+      hsize_t extentDims[]={extent, dims[1]};
+      checkCall(H5Dset_extent(id, extentDims)); // this invalidates fileDataSpaceID -> get it again
+      fileDataSpaceID.reset(H5Dget_space(id), &H5Sclose);
+    }
+  }
+
+  template<class T>
+  void VectorSerie<T>::writeChunksToHDF5(size_t nrRows, size_t cacheSize, const CacheType* data) {
+#if H5_VERSION_GE(1, 10, 3)
+    // the rows of the first chunk written by a previous flush are already included in the extent
+    growExtent(nrRows-flushedCacheRows);
+    for(size_t r=0; r<nrRows; r+=cacheSize)
+      for(size_t colGroup=0; colGroup*chunkColumns<dims[1]; ++colGroup) {
+        encodeChunk(&data[r*dims[1]], cacheSize, colGroup, compressBuf);
+        hsize_t offset[]={dims[0]-nrRows+r, colGroup*chunkColumns};
+        checkCall(H5Dwrite_chunk(id, H5P_DEFAULT, 0, offset, compressBuf.size(), compressBuf.data()));
+      }
+    updateSummary(&data[flushedCacheRows*dims[1]], nrRows-flushedCacheRows);
+    flushedCacheRows=nrRows%cacheSize;
+#endif
+  }
+
+  template<class T>
+  void VectorSerie<T>::encodeChunk(const CacheType* data, size_t cacheSize, size_t colGroup, vector<unsigned char> &out) {
+    size_t chunkElements=cacheSize*chunkColumns;
+    size_t chunkBytes=sizeof(CacheType)*chunkElements;
+    auto src=reinterpret_cast<const Bytef*>(data);
+    // copy the columns of colGroup to a chunk (if the chunk does not contain all columns)
+    vector<CacheType> columns;
+    if(chunkColumns<dims[1]) {
+      columns.resize(chunkElements); // the columns of the last chunk exceeding dims[1] are zero
+      size_t firstCol=colGroup*chunkColumns;
+      size_t nrCols=min<size_t>(chunkColumns, dims[1]-firstCol);
+      for(size_t r=0; r<cacheSize; ++r)
+        copy(&data[r*dims[1]+firstCol], &data[r*dims[1]+firstCol+nrCols], &columns[r*chunkColumns]);
+      src=reinterpret_cast<const Bytef*>(columns.data());
+    }
+    if(compression<=0) {
+      out.assign(src, src+chunkBytes);
+      return;
+    }
+    // apply the filter pipeline like HDF5 does
+    vector<unsigned char> shuffled;
+    if(filter==Filter::shuffleDeflate || filter==Filter::bitshuffleDeflate) {
+      shuffled.resize(chunkBytes);
+      if(filter==Filter::shuffleDeflate)
+        Internal::shuffle(src, shuffled.data(), chunkElements, sizeof(CacheType));
+      else
+        Internal::bitshuffle(src, shuffled.data(), chunkElements, sizeof(CacheType));
+      src=shuffled.data();
+    }
+    uLongf compressedSize=compressBound(chunkBytes);
+    out.resize(compressedSize);
+    if(compress2(out.data(), &compressedSize, src, chunkBytes, compression)!=Z_OK)
+      throw Exception(getPath(), "Compressing a chunk failed.");
+    out.resize(compressedSize);
+  }
+
+  template<class T>
+  void VectorSerie<T>::writeEncodedChunksToHDF5(size_t cacheSize, const vector<vector<unsigned char>> &chunks, const CacheType* data) {
+#if H5_VERSION_GE(1, 10, 3)
+    growExtent(cacheSize-flushedCacheRows);
+    for(size_t colGroup=0; colGroup<chunks.size(); ++colGroup) {
+      hsize_t offset[]={dims[0]-cacheSize, colGroup*chunkColumns};
+      checkCall(H5Dwrite_chunk(id, H5P_DEFAULT, 0, offset, chunks[colGroup].size(), chunks[colGroup].data()));
+    }
+    updateSummary(&data[flushedCacheRows*dims[1]], cacheSize-flushedCacheRows);
+    flushedCacheRows=0; // called by the writer thread: flushCache waits for it before reading flushedCacheRows
+#endif
+  }
+
+  template<class T>
+  void VectorSerie<T>::writeToHDF5(size_t nrRows, size_t cacheSize, const CacheType* data) {
+    if(directChunkWrite) {
+      writeChunksToHDF5(nrRows, cacheSize, data);
+      return;
+    }
+
+    growExtent(nrRows);
 
     hsize_t start[]={dims[0]-nrRows,0};
     hsize_t count[]={nrRows, dims[1]};
@@ -187,29 +463,204 @@ namespace H5 {
       checkCall(H5Dwrite(id, memDataTypeID, memDataSpaceID, fileDataSpaceID, H5P_DEFAULT, data));
     else if(nrRows==cacheSize) // use memDataSpaceCacheID (cacheSize rows)
       checkCall(H5Dwrite(id, memDataTypeID, memDataSpaceCacheID, fileDataSpaceID, H5P_DEFAULT, data));
-    else { // create new memDataSpaceLocalID (nrRows rows) (this is only called once by close())
+    else { // create new memDataSpaceLocalID (nrRows rows) (a partial cache written by flushCache on flush/close or a bulk write of appendRows)
       hsize_t memDims[]={nrRows, dims[1]};
       ScopedHID memDataSpaceLocalID(H5Screate_simple(2, memDims, nullptr), &H5Sclose);
       checkCall(H5Dwrite(id, memDataTypeID, memDataSpaceLocalID, fileDataSpaceID, H5P_DEFAULT, data));
     }
+    updateSummary(data, nrRows);
+  }
+
+  template<class T>
+  void VectorSerie<T>::createSummary(const Options &opts) {
+    if constexpr (!is_arithmetic_v<T>)
+      throw Exception(getPath(), "A summary is only available for datasets of real number types");
+    else {
+      summaryBlockRows=max(opts.summaryBlockRows, 1);
+      createChildAttribute<SimpleAttribute<int> >("Summary Block Rows")()->write(summaryBlockRows);
+
+      // track the creation order of the links like Group does: the group is listed by GroupBase::getChildObjectNames
+      ScopedHID gcpl(H5Pcreate(H5P_GROUP_CREATE), &H5Pclose);
+      checkCall(H5Pset_link_creation_order(gcpl, H5P_CRT_ORDER_TRACKED | H5P_CRT_ORDER_INDEXED));
+      ScopedHID grp(H5Gcreate2(parent->getID(), (name+summaryGroupSuffix).c_str(), H5P_DEFAULT, gcpl, H5P_DEFAULT), &H5Gclose);
+      hsize_t summaryDims[]={0, 3*dims[1]};
+      hsize_t maxDims[]={H5S_UNLIMITED, 3*dims[1]};
+      ScopedHID space(H5Screate_simple(2, summaryDims, maxDims), &H5Sclose);
+      ScopedHID propID(H5Pcreate(H5P_DATASET_CREATE), &H5Pclose);
+      hsize_t chunkDims[]={256, 3}; // min, max, mean of one column
+      checkCall(H5Pset_chunk(propID, 2, chunkDims));
+      if(opts.compression>0)
+        checkCall(H5Pset_deflate(propID, opts.compression));
+      summary.resize(opts.summaryLevels);
+      for(size_t l=0; l<summary.size(); ++l) {
+        summary[l].id.reset(H5Dcreate2(grp, ("level"+to_string(l)).c_str(), H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, propID, H5P_DEFAULT),
+                            &H5Dclose);
+        summary[l].acc.resize(3*dims[1]);
+      }
+    }
+  }
+
+  template<class T>
+  void VectorSerie<T>::openSummary() {
+    for(size_t l=0; l<summary.size(); ++l)
+      summary[l].id.reset(H5Dopen(parent->getID(), (name+summaryGroupSuffix+"/level"+to_string(l)).c_str(), H5P_DEFAULT), &H5Dclose);
+  }
+
+  template<class T>
+  void VectorSerie<T>::updateSummary(const CacheType* data, size_t nrRows) {
+    if constexpr (is_arithmetic_v<T>) {
+      if(summary.empty())
+        return;
+      size_t cols=dims[1];
+      vector<double> row(3*cols);
+      for(size_t r=0; r<nrRows; ++r) {
+        for(size_t c=0; c<cols; ++c) {
+          double v=data[r*cols+c];
+          row[3*c]=v;
+          row[3*c+1]=v;
+          row[3*c+2]=v;
+        }
+        addToSummary(0, row.data(), 1);
+      }
+      // write the completed blocks of all levels
+      for(auto &level : summary) {
+        if(level.pending.empty())
+          continue;
+        hsize_t count[]={level.pending.size()/(3*cols), 3*cols};
+        hsize_t extentDims[]={level.rows+count[0], 3*cols};
+        checkCall(H5Dset_extent(level.id, extentDims));
+        ScopedHID space(H5Dget_space(level.id), &H5Sclose);
+        hsize_t start[]={level.rows, 0};
+        checkCall(H5Sselect_hyperslab(space, H5S_SELECT_SET, start, nullptr, count, nullptr));
+        ScopedHID memSpace(H5Screate_simple(2, count, nullptr), &H5Sclose);
+        checkCall(H5Dwrite(level.id, H5T_NATIVE_DOUBLE, memSpace, space, H5P_DEFAULT, level.pending.data()));
+        level.rows+=count[0];
+        level.pending.clear();
+      }
+    }
+  }
+
+  template<class T>
+  void VectorSerie<T>::addToSummary(size_t l, const double *block, size_t nrRows) {
+    auto &level=summary[l];
+    size_t cols=dims[1];
+    if(level.accRows==0)
+      for(size_t c=0; c<cols; ++c) {
+        level.acc[3*c]=numeric_limits<double>::infinity();
+        level.acc[3*c+1]=-numeric_limits<double>::infinity();
+        level.acc[3*c+2]=0;
+      }
+    for(size_t c=0; c<cols; ++c) {
+      if(block[3*c]<level.acc[3*c]) // false for NaN
+        level.acc[3*c]=block[3*c];
+      if(block[3*c+1]>level.acc[3*c+1])
+        level.acc[3*c+1]=block[3*c+1];
+      level.acc[3*c+2]+=block[3*c+2];
+    }
+    level.accRows+=nrRows;
+    if(level.accRows<(summaryBlockRows<<l))
+      return;
+
+    // the block is complete: store min, max and mean and add it to the next level
+    for(size_t c=0; c<cols; ++c) {
+      bool valid=level.acc[3*c]<=level.acc[3*c+1]; // false if all values are NaN
+      level.pending.push_back(valid ? level.acc[3*c] : numeric_limits<double>::quiet_NaN());
+      level.pending.push_back(valid ? level.acc[3*c+1] : numeric_limits<double>::quiet_NaN());
+      level.pending.push_back(level.acc[3*c+2]/level.accRows);
+    }
+    if(l+1<summary.size())
+      addToSummary(l+1, level.acc.data(), level.accRows);
+    level.accRows=0;
   }
 
   template<class T>
   void VectorSerie<T>::append(const T data[], size_t size) {
     if(size!=dims[1]) throw Exception(getPath(), "dataset dimension does not match");
 
-    auto cacheSize=cache.shape()[0];
+    slotPending=false;
+    auto cacheSize=getCacheSize();
     if(cacheSize>1) {
+      if(cacheRow>=cacheSize) { // the cache block was filled by appendSlot
+        writeCache(cacheSize);
+        cacheRow=0;
+      }
       for(size_t i=0; i<size; ++i)
-        cache[cacheRow][i]=data[i];
+        cache[cacheBlock][cacheRow][i]=data[i];
       cacheRow++;
       if(cacheRow>=cacheSize) {
-        writeToHDF5(cacheSize, cacheSize, cache.data());
+        writeCache(cacheSize);
         cacheRow=0;
       }
     }
     else
       writeToHDF5(1, cacheSize, data);
+    markDirty();
+    file->autoFlushPoint(++rowsSinceFlush);
+  }
+
+  template<class T>
+  void VectorSerie<T>::appendRows(const T data[], size_t nrRows, size_t size) {
+    if(size!=dims[1]) throw Exception(getPath(), "dataset dimension does not match");
+
+    if constexpr (is_same_v<T, string>) {
+      // strings need a conversion for each row anyway
+      for(size_t r=0; r<nrRows; ++r)
+        append(&data[r*size], size);
+    }
+    else {
+      slotPending=false;
+      auto cacheSize=getCacheSize();
+      size_t r=0;
+      // fill the current (partial) cache block first
+      if(cacheSize>1) {
+        if(cacheRow>=cacheSize) { // the cache block was filled by appendSlot
+          writeCache(cacheSize);
+          cacheRow=0;
+        }
+        for(; cacheRow>0 && r<nrRows; ++r) {
+          copy(&data[r*size], &data[(r+1)*size], &cache[cacheBlock][cacheRow][0]);
+          if(++cacheRow>=cacheSize) {
+            writeCache(cacheSize);
+            cacheRow=0;
+          }
+        }
+      }
+      // write all remaining full cache blocks at once directly from data
+      size_t bulkRows=cacheSize>1 ? (nrRows-r)/cacheSize*cacheSize : nrRows-r;
+      if(bulkRows>0) {
+        waitForAsyncWrite();
+        writeToHDF5(bulkRows, cacheSize, &data[r*size]);
+        r+=bulkRows;
+      }
+      // store the remaining rows in the cache
+      for(; r<nrRows; ++r, ++cacheRow)
+        copy(&data[r*size], &data[(r+1)*size], &cache[cacheBlock][cacheRow][0]);
+      markDirty();
+      file->autoFlushPoint(rowsSinceFlush+=nrRows);
+    }
+  }
+
+  template<class T>
+  T* VectorSerie<T>::appendSlot() {
+    if constexpr (is_same_v<T, string>)
+      throw Exception(getPath(), "appendSlot is not available for string datasets");
+    else {
+      auto cacheSize=getCacheSize();
+      if(cacheSize<=1)
+        throw Exception(getPath(), "appendSlot is only available for datasets with a cache");
+      // the row returned by the last call is filled now: the file may be flushed
+      slotPending=false;
+      file->autoFlushPoint(rowsSinceFlush);
+      // the filled cache block is written on the next call (the caller may still write to the last returned row)
+      if(cacheRow>=cacheSize) {
+        writeCache(cacheSize);
+        cacheRow=0;
+      }
+      markDirty();
+      rowsSinceFlush++;
+      slotPending=true;
+      return &cache[cacheBlock][cacheRow++][0];
+    }
   }
 
   template<class T>
@@ -225,6 +676,28 @@ namespace H5 {
       return;
     }
 
+    if constexpr (is_arithmetic_v<T>)
+      if(file->getType()==File::read && file->getChunkCacheBudget()>0) {
+        // read the full chunk row into the shared chunk cache of the file and copy the row from there
+        using Entry = Internal::ChunkCache::TypedEntry<T>;
+        auto &chunkCache=file->getChunkCache();
+        size_t firstRow=row/chunkRows*chunkRows;
+        Internal::ChunkCache::Key key{this, row/chunkRows};
+        auto entry=static_pointer_cast<const Entry>(chunkCache.get(key, row-firstRow+1)); // all entries of this are of type Entry
+        if(!entry) {
+          auto newEntry=make_shared<Entry>();
+          newEntry->rows=min<size_t>(chunkRows, rows-firstRow);
+          newEntry->data.resize(newEntry->rows*dims[1]);
+          newEntry->bytes=sizeof(T)*newEntry->data.size();
+          getRows(firstRow, newEntry->rows, dims[1], newEntry->data.data());
+          chunkCache.put(key, newEntry);
+          entry=std::move(newEntry);
+        }
+        auto rowData=&entry->data[(row-firstRow)*dims[1]];
+        copy(rowData, rowData+dims[1], data);
+        return;
+      }
+
     hsize_t start[]={(hsize_t)row,0};
     hsize_t count[]={1, dims[1]};
     checkCall(H5Sselect_hyperslab(fileDataSpaceID, H5S_SELECT_SET, start, nullptr, count, nullptr));
@@ -246,6 +719,359 @@ namespace H5 {
     checkCall(H5Dread(id, memDataTypeID, colDataSpaceID, fileDataSpaceID, H5P_DEFAULT, data));
   }
 
+  template<class T>
+  void VectorSerie<T>::readSelection(hid_t memSpaceID, hid_t fileSpaceID, size_t nrElements, T data[]) {
+    if constexpr (is_same_v<T, string>) {
+      if(H5Tis_variable_str(memDataTypeID)) {
+        VecStr dummy(nrElements);
+        checkCall(H5Dread(id, memDataTypeID, memSpaceID, fileSpaceID, H5P_DEFAULT, &dummy[0]));
+        for(size_t i=0; i<nrElements; i++)
+          data[i]=dummy[i];
+      }
+      else {
+        auto fixedStrSize=H5Tget_size(memDataTypeID);
+        vector<char> buf(fixedStrSize*nrElements);
+        checkCall(H5Dread(id, memDataTypeID, memSpaceID, fileSpaceID, H5P_DEFAULT, buf.data()));
+        for(size_t i=0; i<nrElements; i++) {
+          char *start=&buf[i*fixedStrSize];
+          data[i]=string(start, strnlen(start, fixedStrSize));
+        }
+      }
+    }
+    else
+      checkCall(H5Dread(id, memDataTypeID, memSpaceID, fileSpaceID, H5P_DEFAULT, data));
+  }
+
+  template<class T>
+  void VectorSerie<T>::getRows(size_t firstRow, size_t nrRows, size_t size, T data[]) {
+    if(size!=dims[1])
+      throw Exception(getPath(), "Size of data does not match");
+    if(nrRows==0)
+      return;
+    size_t rows=getRows();
+    if(firstRow+nrRows>rows)
+      throw Exception(getPath(), "Requested rows ["+to_string(firstRow)+".."+to_string(firstRow+nrRows)+"[ are out of range [0.."+
+                                 to_string(rows)+"[");
+    readRows(fileDataSpaceID, firstRow, nrRows, data);
+  }
+
+  template<class T>
+  void VectorSerie<T>::readRows(hid_t fileSpaceID, size_t firstRow, size_t nrRows, T data[]) {
+    hsize_t start[]={firstRow, 0};
+    hsize_t count[]={nrRows, dims[1]};
+    checkCall(H5Sselect_hyperslab(fileSpaceID, H5S_SELECT_SET, start, nullptr, count, nullptr));
+    ScopedHID rowsDataSpaceID(H5Screate_simple(2, count, nullptr), &H5Sclose);
+    readSelection(rowsDataSpaceID, fileSpaceID, nrRows*dims[1], data);
+  }
+
+  template<class T>
+  VectorSerie<T>::RowRange::RowRange(VectorSerie<T> *ds_, size_t firstRow_, size_t nrRows, size_t blockRows_, bool prefetch_) :
+    ds(ds_), firstRow(firstRow_), blockRows(blockRows_>0 ? blockRows_ : ds->chunkRows), prefetch(prefetch_) {
+    size_t rows=ds->getRows();
+    firstRow=min(firstRow, rows);
+    endRow=firstRow+min(nrRows, rows-firstRow);
+    fileSpaceID.reset(H5Scopy(ds->fileDataSpaceID), &H5Sclose);
+    if(prefetch) {
+      static bool threadSafe=[](){
+        hbool_t threadSafe;
+        checkCall(H5is_library_threadsafe(&threadSafe));
+        return threadSafe;
+      }();
+      prefetch=threadSafe; // read synchronously if the HDF5 library is not thread-safe
+    }
+  }
+
+  template<class T>
+  VectorSerie<T>::RowRange::~RowRange() {
+    if(next.valid())
+      next.wait();
+  }
+
+  template<class T>
+  void VectorSerie<T>::RowRange::readBlock(size_t first, vector<T> &data) {
+    size_t n=blockEnd(first)-first;
+    data.resize(n*ds->dims[1]);
+    ds->readRows(fileSpaceID, first, n, data.data());
+  }
+
+  template<class T>
+  const T* VectorSerie<T>::RowRange::getRowData(size_t row) {
+    if(row<blockFirst || row>=blockEnd(blockFirst)) {
+      size_t first=max(firstRow, row/blockRows*blockRows);
+      if(next.valid()) {
+        next.get(); // rethrows a exception of the prefetch
+        if(nextFirst==first)
+          swap(block, nextBlock);
+      }
+      if(nextFirst!=first)
+        readBlock(first, block);
+      blockFirst=first;
+      nextFirst=blockEnd(first);
+      if(prefetch && nextFirst<endRow)
+        next=async(launch::async, [this](){
+          installErrorHandler(); // the error handler is per thread
+          readBlock(nextFirst, nextBlock);
+        });
+      else
+        nextFirst=numeric_limits<size_t>::max();
+    }
+    return &block[(row-blockFirst)*ds->dims[1]];
+  }
+
+  template<class T>
+  void VectorSerie<T>::getColumn(const int column, size_t firstRow, size_t nrRows, size_t stride, T data[]) {
+    if(nrRows==0)
+      return;
+    if(stride==0)
+      throw Exception(getPath(), "The stride must be greater than 0");
+    size_t rows=getRows();
+    if(firstRow+(nrRows-1)*stride>=rows)
+      throw Exception(getPath(), "Requested rows are out of range [0.."+to_string(rows)+"[");
+    if(column<0 || static_cast<hsize_t>(column)>=dims[1])
+      throw Exception(getPath(), "Requested column is out of range [0.."+to_string(dims[1])+"[");
+    hsize_t start[]={firstRow, static_cast<hsize_t>(column)};
+    hsize_t strides[]={stride, 1};
+    hsize_t count[]={nrRows, 1};
+    checkCall(H5Sselect_hyperslab(fileDataSpaceID, H5S_SELECT_SET, start, strides, count, nullptr));
+    ScopedHID colDataSpaceID(H5Screate_simple(2, count, nullptr), &H5Sclose);
+    readSelection(colDataSpaceID, fileDataSpaceID, nrRows, data);
+  }
+
+  template<class T>
+  void VectorSerie<T>::getColumns(const vector<int> &columns, size_t firstRow, size_t nrRows, T data[]) {
+    if(columns.empty() || nrRows==0)
+      return;
+    size_t rows=getRows();
+    if(firstRow+nrRows>rows)
+      throw Exception(getPath(), "Requested rows ["+to_string(firstRow)+".."+to_string(firstRow+nrRows)+"[ are out of range [0.."+
+                                 to_string(rows)+"[");
+    // the distinct columns in ascending order (a union of hyperslabs is read in this order)
+    vector<int> sel(columns);
+    sort(sel.begin(), sel.end());
+    sel.erase(unique(sel.begin(), sel.end()), sel.end());
+    if(sel.front()<0 || static_cast<hsize_t>(sel.back())>=dims[1])
+      throw Exception(getPath(), "Requested column is out of range [0.."+to_string(dims[1])+"[");
+    vector<size_t> pos(columns.size()); // position of columns[i] in sel
+    for(size_t i=0; i<columns.size(); ++i)
+      pos[i]=lower_bound(sel.begin(), sel.end(), columns[i])-sel.begin();
+
+    // read blocks of full chunk rows (about 64k elements): each chunk is read only once and the buffer stays small
+    hsize_t blockRows=max<hsize_t>(1, (1<<16)/sel.size()/chunkRows)*chunkRows;
+    vector<T> buf(min<hsize_t>(blockRows, nrRows)*sel.size());
+    for(size_t r=firstRow; r<firstRow+nrRows;) {
+      hsize_t n=min<hsize_t>(r/chunkRows*chunkRows+blockRows-r, firstRow+nrRows-r); // end the block at a chunk boundary
+      // select each range of consecutive columns by one hyperslab
+      for(size_t i=0; i<sel.size();) {
+        size_t j=i+1;
+        while(j<sel.size() && sel[j]==sel[j-1]+1)
+          ++j;
+        hsize_t start[]={r, static_cast<hsize_t>(sel[i])};
+        hsize_t count[]={n, j-i};
+        checkCall(H5Sselect_hyperslab(fileDataSpaceID, i==0 ? H5S_SELECT_SET : H5S_SELECT_OR, start, nullptr, count, nullptr));
+        i=j;
+      }
+      hsize_t memDims[]={n, sel.size()};
+      ScopedHID memSpaceID(H5Screate_simple(2, memDims, nullptr), &H5Sclose);
+      readSelection(memSpaceID, fileDataSpaceID, n*sel.size(), buf.data());
+      // scatter the row-major buffer to the column-major output
+      for(size_t i=0; i<columns.size(); ++i) {
+        T *out=&data[i*nrRows+r-firstRow];
+        for(size_t k=0; k<n; ++k)
+          out[k]=buf[k*sel.size()+pos[i]];
+      }
+      r+=n;
+    }
+  }
+
+  template<class T>
+  size_t VectorSerie<T>::getRowsSince(size_t &lastSeen, vector<T> &data) {
+    size_t rows=getRows();
+    if(rows<lastSeen) {
+      data.clear();
+      lastSeen=0;
+    }
+    size_t nrRows=rows-lastSeen;
+    size_t oldSize=data.size();
+    data.resize(oldSize+nrRows*dims[1]);
+    getRows(lastSeen, nrRows, dims[1], data.data()+oldSize);
+    lastSeen=rows;
+    return nrRows;
+  }
+
+  template<class T>
+  size_t VectorSerie<T>::getColumnsSince(const vector<int> &columns, size_t &lastSeen, vector<vector<T>> &data) {
+    size_t rows=getRows();
+    data.resize(columns.size());
+    if(rows<lastSeen) {
+      for(auto &d : data)
+        d.clear();
+      lastSeen=0;
+    }
+    size_t nrRows=rows-lastSeen;
+    if(nrRows>0) {
+      vector<T> buf(columns.size()*nrRows);
+      getColumns(columns, lastSeen, nrRows, buf.data());
+      for(size_t i=0; i<columns.size(); ++i)
+        data[i].insert(data[i].end(), make_move_iterator(buf.begin()+i*nrRows), make_move_iterator(buf.begin()+(i+1)*nrRows));
+    }
+    lastSeen=rows;
+    return nrRows;
+  }
+
+  template<class T>
+  bool VectorSerie<T>::isMappable() {
+    if(mappable<0) {
+      mappable=0;
+#if H5_VERSION_GE(1, 10, 5)
+      if constexpr (!is_same_v<T, string>) {
+        ScopedHID cpl(H5Dget_create_plist(id), &H5Pclose);
+        ScopedHID fileType(H5Dget_type(id), &H5Tclose);
+        ScopedHID fapl(H5Fget_access_plist(file->getID()), &H5Pclose);
+        if(file->getType()==File::read && H5Pget_nfilters(cpl)==0 && H5Tequal(fileType, memDataTypeID)>0 &&
+           H5Pget_driver(fapl)==H5FD_SEC2) {
+          ScopedHID fcpl(H5Fget_create_plist(file->getID()), &H5Pclose);
+          checkCall(H5Pget_userblock(fcpl, &userblockSize)); // chunk addresses are relative to the end of the user block
+          mappable=1;
+        }
+      }
+#endif
+    }
+    return mappable==1;
+  }
+
+  template<class T>
+  bool VectorSerie<T>::mapChunk(size_t row, size_t column, MappedChunk &chunk) {
+#if H5_VERSION_GE(1, 10, 5)
+    if constexpr (!is_same_v<T, string>) {
+      if(!isMappable())
+        return false;
+      size_t rows=getRows();
+      if(row>=rows || column>=dims[1])
+        return false;
+      hsize_t offset[]={row/chunkRows*chunkRows, column/chunkColumns*chunkColumns};
+      unsigned filterMask;
+      haddr_t addr;
+      hsize_t size;
+      checkCall(H5Dget_chunk_info_by_coord(id, offset, &filterMask, &addr, &size));
+      if(addr==HADDR_UNDEF || size!=sizeof(T)*chunkRows*chunkColumns)
+        return false; // the chunk is not written yet
+      size_t start=userblockSize+addr;
+      if(start%alignof(T)!=0)
+        return false; // HDF5 does not align chunks: we cannot access the data in place
+      if(!mappedRegion.get_address() || start+size>mappedRegion.get_size()) {
+        // (re)map the whole file (a SWMR reader sees a growing file)
+        string filename(H5Fget_name(id, nullptr, 0)+1, '\0');
+        H5Fget_name(id, filename.data(), filename.size());
+        filename.pop_back();
+        fileMapping=boost::interprocess::file_mapping(filename.c_str(), boost::interprocess::read_only);
+        mappedRegion=boost::interprocess::mapped_region(fileMapping, boost::interprocess::read_only);
+        if(start+size>mappedRegion.get_size())
+          return false;
+      }
+      chunk.data=reinterpret_cast<const T*>(static_cast<const char*>(mappedRegion.get_address())+start);
+      chunk.firstRow=offset[0];
+      chunk.nrRows=min<size_t>(chunkRows, rows-offset[0]);
+      chunk.firstColumn=offset[1];
+      chunk.nrColumns=min<size_t>(chunkColumns, dims[1]-offset[1]);
+      chunk.rowStride=chunkColumns;
+      return true;
+    }
+#endif
+    return false;
+  }
+
+  template<class T>
+  int VectorSerie<T>::getSummaryLevels() {
+    string grpName=name+summaryGroupSuffix;
+    if(H5Lexists(parent->getID(), grpName.c_str(), H5P_DEFAULT)<=0)
+      return 0;
+    ScopedHID grp(H5Gopen2(parent->getID(), grpName.c_str(), H5P_DEFAULT), &H5Gclose);
+    H5G_info_t info;
+    checkCall(H5Gget_info(grp, &info));
+    return info.nlinks;
+  }
+
+  template<class T>
+  size_t VectorSerie<T>::getSummaryBlockRows() {
+    if(summaryBlockRows==0)
+      summaryBlockRows=openChildAttribute<SimpleAttribute<int> >("Summary Block Rows")->read();
+    return summaryBlockRows;
+  }
+
+  template<class T>
+  void VectorSerie<T>::getSummary(int level, int column, vector<double> &min, vector<double> &max, vector<double> &mean) {
+    if constexpr (!is_arithmetic_v<T>)
+      throw Exception(getPath(), "A summary is only available for datasets of real number types");
+    else {
+      int levels=getSummaryLevels();
+      if(level<0 || level>=levels)
+        throw Exception(getPath(), "Requested summary level is out of range [0.."+to_string(levels)+"[");
+      if(column<0 || static_cast<hsize_t>(column)>=dims[1])
+        throw Exception(getPath(), "Requested column is out of range [0.."+to_string(dims[1])+"[");
+      size_t blockRows=getSummaryBlockRows();
+      size_t rows=getRows();
+
+      // read min, max, mean of column of the blocks [first, end) of level l to buf
+      vector<double> buf;
+      auto readLevel=[this, column, &buf](int l, hsize_t first) {
+        ScopedHID d(H5Dopen(parent->getID(), (name+summaryGroupSuffix+"/level"+to_string(l)).c_str(), H5P_DEFAULT), &H5Dclose);
+        ScopedHID space(H5Dget_space(d), &H5Sclose);
+        hsize_t summaryDims[2];
+        checkCall(H5Sget_simple_extent_dims(space, summaryDims, nullptr));
+        buf.clear();
+        if(first>=summaryDims[0])
+          return;
+        hsize_t start[]={first, 3*static_cast<hsize_t>(column)};
+        hsize_t count[]={summaryDims[0]-first, 3};
+        checkCall(H5Sselect_hyperslab(space, H5S_SELECT_SET, start, nullptr, count, nullptr));
+        ScopedHID memSpace(H5Screate_simple(2, count, nullptr), &H5Sclose);
+        buf.resize(3*count[0]);
+        checkCall(H5Dread(d, H5T_NATIVE_DOUBLE, memSpace, space, H5P_DEFAULT, buf.data()));
+      };
+
+      readLevel(level, 0);
+      size_t n=buf.size()/3;
+      min.resize(n);
+      max.resize(n);
+      mean.resize(n);
+      for(size_t i=0; i<n; ++i) {
+        min[i]=buf[3*i];
+        max[i]=buf[3*i+1];
+        mean[i]=buf[3*i+2];
+      }
+
+      // the rows after the last complete block: the complete blocks of the lower levels and the remaining rows
+      size_t covered=n*(blockRows<<level);
+      double tailMin=numeric_limits<double>::infinity(), tailMax=-numeric_limits<double>::infinity(), tailSum=0;
+      size_t tailRows=0;
+      auto add=[&](double mi, double ma, double sum, size_t nrRows) {
+        if(mi<tailMin) tailMin=mi;
+        if(ma>tailMax) tailMax=ma;
+        tailSum+=sum;
+        tailRows+=nrRows;
+      };
+      for(int l=level-1; l>=0; --l) {
+        size_t levelBlockRows=blockRows<<l;
+        readLevel(l, covered/levelBlockRows);
+        for(size_t i=0; i<buf.size()/3; ++i)
+          add(buf[3*i], buf[3*i+1], buf[3*i+2]*levelBlockRows, levelBlockRows);
+        covered+=buf.size()/3*levelBlockRows;
+      }
+      if(covered<rows) {
+        vector<T> data(rows-covered);
+        getColumn(column, covered, data.size(), 1, data.data());
+        for(auto &v : data)
+          add(v, v, v, 1);
+      }
+      if(tailRows>0) {
+        bool valid=tailMin<=tailMax;
+        min.push_back(valid ? tailMin : numeric_limits<double>::quiet_NaN());
+        max.push_back(valid ? tailMax : numeric_limits<double>::quiet_NaN());
+        mean.push_back(tailSum/tailRows);
+      }
+    }
+  }
+
   template<class T>
   string VectorSerie<T>::getDescription() {
     auto *desc=openChildAttribute<SimpleAttribute<string> >("Description");
@@ -268,11 +1094,20 @@ namespace H5 {
 
   template<class T>
   void VectorSerie<T>::enableSWMR() {
-    if(file->getType(true) == File::writeWithRename)
+    if(file->getType(true) == File::writeWithRename) {
       openIDandFileDataSpaceID();
+      openSummary();
+    }
     Dataset::enableSWMR();
   }
 
+  template<class T>
+  void VectorSerie<T>::reopen() {
+    openIDandFileDataSpaceID();
+    openSummary();
+    Dataset::reopen();
+  }
+
 
 
   // explizit template spezialisations
@@ -281,7 +1116,7 @@ namespace H5 {
   void VectorSerie<string>::append(const string data[], size_t size) {
     if(size!=dims[1]) throw Exception(getPath(), "dataset dimension does not match");
 
-    auto cacheSize=cacheFixedSizeStr.shape()[0];
+    auto cacheSize=getCacheSize();
     if(cacheSize>1) {
       auto fixedStrSize=H5Tget_size(memDataTypeID);
       for(size_t i=0; i<size; ++i) {
@@ -289,21 +1124,19 @@ namespace H5 {
         if(strSize>fixedStrSize)
           throw Exception(getPath(), "The string to write has length "+to_string(data[i].size())+
                                      " which is longer than the defined fixed string size of "+to_string(fixedStrSize)+".");
-        memcpy(&cacheFixedSizeStr[cacheRow][i][0], data[i].data(), strSize);
+        memcpy(&cacheFixedSizeStr[cacheBlock][cacheRow][i][0], data[i].data(), strSize);
         if(strSize<fixedStrSize)
-          memset(&cacheFixedSizeStr[cacheRow][i][strSize], 0, fixedStrSize-strSize);
+          memset(&cacheFixedSizeStr[cacheBlock][cacheRow][i][strSize], 0, fixedStrSize-strSize);
       }
       cacheRow++;
       if(cacheRow>=cacheSize) {
-        writeToHDF5(cacheSize, cacheSize, cacheFixedSizeStr.data());
+        writeCache(cacheSize);
         cacheRow=0;
       }
     }
     else {
-      dims[0]++;
-      checkCall(H5Dset_extent(id, dims)); // this invalidates fileDataSpaceID -> get it again
-      fileDataSpaceID.reset(H5Dget_space(id), &H5Sclose);
-    
+      growExtent(1);
+
       hsize_t start[]={dims[0]-1,0};
       hsize_t count[]={1, dims[1]};
       checkCall(H5Sselect_hyperslab(fileDataSpaceID, H5S_SELECT_SET, start, nullptr, count, nullptr));
@@ -328,6 +1161,8 @@ namespace H5 {
         checkCall(H5Dwrite(id, memDataTypeID, memDataSpaceID, fileDataSpaceID, H5P_DEFAULT, &bufChar[0]));
       }
     }
+    markDirty();
+    file->autoFlushPoint(++rowsSinceFlush);
   }
 
   template<>
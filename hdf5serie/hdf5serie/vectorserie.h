@@ -26,11 +26,18 @@
 #include <hdf5serie/file.h>
 #include "hdf5serie/options.h"
 #include <vector>
+#include <atomic>
+#include <limits>
 #include <boost/multi_array.hpp>
+#include <boost/interprocess/file_mapping.hpp>
 
 namespace H5 {
 
-
+  //! the name of the summary group of a VectorSerie is the name of the dataset with this suffix
+  constexpr const char *summaryGroupSuffix = ".summary";
+  //! the name of the dataset holding the number of written rows of a VectorSerie with reserved extent (see Options::reserveExtent)
+  //! is the name of the dataset with this suffix
+  constexpr const char *rowsDatasetSuffix = ".rows";
    
   /** \brief Serie of vectors.
    *
@@ -60,22 +67,101 @@ namespace H5 {
    * the size of the vector, and operator[](int i) returns for i=0 a reference to the first element and
    * all other elements are store continously after the address of this element, then you
    * can use the vector-object as parameter for append(const DataType &data).
+   *
+   * Summary pyramid (if Options::summaryLevels>0):
+   * The writer stores an overview of the data in the group <name>.summary (see summaryGroupSuffix) next to the dataset.
+   * It contains the 2D datasets "level0", "level1", ... of type double. Each row of level l summarizes a block of
+   * B*2^l rows of the dataset, B being the value of the integer attribute "Summary Block Rows" of the dataset.
+   * The row has 3 columns for each column c of the dataset: 3*c = min, 3*c+1 = max, 3*c+2 = mean (NaN values
+   * are ignored for min and max). Only complete blocks are written; the rows after the last complete block are
+   * summarized by getSummary using the lower levels and the dataset itself.
+   * The datasets are chunked by 3 columns: the summary of a single column is read without reading the others.
   */
   template<class T>
   class VectorSerie : public Dataset {
     friend class Container<Object, GroupBase>;
     private:
+      using CacheType = std::conditional_t<std::is_same_v<T,std::string>,char,T>;
       ScopedHID memDataTypeID;
       ScopedHID memDataSpaceID;
       ScopedHID memDataSpaceCacheID;
       ScopedHID fileDataSpaceID;
       hsize_t dims[2];
-      boost::multi_array<T, 2> cache;
-      boost::multi_array<char, 3> cacheFixedSizeStr;
+      hsize_t chunkRows { 1 }; // number of rows of a chunk
+      hsize_t chunkColumns { 0 }; // number of columns of a chunk
+      bool reserveExtent { false };
+      hsize_t extent { 0 }; // the number of rows of the dataset in the file (>dims[0] if reserveExtent is set)
+      ScopedHID rowsID; // the dataset <name>.rows with the number of written rows (if the dataset was created with reserveExtent)
+      int rowCount { -1 }; // reader: the number of written rows read from rowsID (-1 if not available)
+      bool directChunkWrite { false };
+      Filter filter { Filter::deflate }; // the filter used for direct chunk writes
+      int compression { 0 }; // the compression level used for direct chunk writes
+      size_t flushedCacheRows { 0 }; // number of rows of the current cache block already written (by flush) with direct chunk write or while slotPending is set
+      bool slotPending { false }; // the last row returned by appendSlot may not be filled yet (it is not written by a flush)
+      std::vector<unsigned char> compressBuf;
+      //! encode (copy the columns of colGroup and compress) the chunk colGroup of the cacheSize rows of data to out (thread-safe)
+      void encodeChunk(const CacheType* data, size_t cacheSize, size_t colGroup, std::vector<unsigned char> &out);
+      //! write nrRows rows (full chunks, except the last one) using H5Dwrite_chunk
+      void writeChunksToHDF5(size_t nrRows, size_t cacheSize, const CacheType* data);
+      //! write the already encoded chunks (of all column groups) of a full chunk row using H5Dwrite_chunk
+      void writeEncodedChunksToHDF5(size_t cacheSize, const std::vector<std::vector<unsigned char>> &chunks, const CacheType* data);
+      // the cache is a ring of blocks [block][row][column] (more than one block is only used if asyncWrite is set):
+      // a filled block is passed to the writer thread without copying and the next block is filled meanwhile
+      boost::multi_array<T, 3> cache;
+      boost::multi_array<char, 4> cacheFixedSizeStr;
       std::vector<char> bufChar;
-      size_t cacheRow;
-      void writeToHDF5(size_t nrRows, size_t cacheSize, const std::conditional_t<std::is_same_v<T,std::string>,char,T>* data);
+      size_t cacheRow { 0 }; // the next free row in the current cache block
+      size_t cacheBlock { 0 }; // the current cache block
+      size_t rowsSinceFlush { 0 }; // number of rows appended since the last flush (for the auto-flush of the file)
+      bool asyncWrite { false };
+      size_t submittedBlocks { 0 }; // number of cache blocks passed to the writer thread
+      std::atomic<size_t> writtenBlocks { 0 }; // number of cache blocks written by the writer thread
+      size_t getCacheSize() const;
+      //! returns the current cache block
+      CacheType* getCacheBlock();
+      //! write the rows of the current cache block not written yet (by flush or close)
+      void flushCache();
+      void writeToHDF5(size_t nrRows, size_t cacheSize, const CacheType* data);
+      //! write the first nrRows rows of the current cache block (except the rows already written by flushCache)
+      //! (synchronous or by the writer thread of the file if asyncWrite is set)
+      //! and switch to the next cache block
+      void writeCache(size_t nrRows);
+      //! wait until all cache blocks passed to the writer thread of the file are written
+      void waitForAsyncWrite();
+      //! add nrRows to the written rows and grow the extent of the dataset in the file if needed
+      void growExtent(size_t nrRows);
+      //! shrink the extent of the dataset in the file to the written rows (if reserveExtent is set, only done by close)
+      void trimExtent();
+      //! writer: store the number of written rows in <name>.rows; reader: read it to rowCount
+      void writeRowCount();
+      void readRowCount();
       void openIDandFileDataSpaceID();
+      void setChunkCache(hid_t apl, hsize_t chunkRows);
+      struct SummaryLevel {
+        ScopedHID id;
+        hsize_t rows { 0 }; // number of blocks written
+        std::vector<double> acc; // min, max and sum of each column of the current block
+        size_t accRows { 0 }; // number of rows in acc
+        std::vector<double> pending; // blocks not written yet (min, max and mean of each column)
+      };
+      std::vector<SummaryLevel> summary;
+      size_t summaryBlockRows { 0 };
+      // zero-copy reads (see mapChunk)
+      int mappable { -1 }; // -1 = not checked yet, 0 = no, 1 = yes
+      hsize_t userblockSize { 0 };
+      boost::interprocess::file_mapping fileMapping;
+      boost::interprocess::mapped_region mappedRegion;
+      bool isMappable();
+      void createSummary(const Options &opts);
+      void openSummary();
+      //! add nrRows rows (the new rows written to the dataset) to the summary
+      void updateSummary(const CacheType* data, size_t nrRows);
+      //! add a block (min, max and sum of each column) of nrRows rows to the current block of level
+      void addToSummary(size_t level, const double *block, size_t nrRows);
+      //! read the current selection of fileSpaceID to data (nrElements elements, stored as given by memSpaceID)
+      void readSelection(hid_t memSpaceID, hid_t fileSpaceID, size_t nrElements, T data[]);
+      //! read the rows [firstRow, firstRow+nrRows[ to data (row-major) using the dataspace fileSpaceID for the selection
+      void readRows(hid_t fileSpaceID, size_t firstRow, size_t nrRows, T data[]);
     protected:
       VectorSerie(int dummy, GroupBase *parent_, const std::string &name_);
       VectorSerie(GroupBase *parent_, const std::string &name_, int cols, const Options &opts={});
@@ -84,6 +170,7 @@ namespace H5 {
       void refresh() override;
       void flush() override;
       void enableSWMR() override;
+      void reopen() override;
 
     public:
       /** \brief Sets a description for the dataset
@@ -108,6 +195,31 @@ namespace H5 {
         append(&data[0], data.size());
       }
 
+      /** \brief Append many data vectors
+       *
+       * Appends nrRows data vectors stored row-major in \a data (nrRows*size elements).
+       * The current cache block is filled first, then all remaining full cache blocks are written by one HDF5 call
+       * (directly from \a data) and the remaining rows are stored in the cache.
+       */
+      void appendRows(const T data[], size_t nrRows, size_t size);
+
+      /** Convinience appendRows function for a row-major matrix (e.g. a boost::multi_array<T,2>). */
+      void appendRows(const boost::const_multi_array_ref<T, 2> &data) {
+        if(!(data.storage_order()==boost::c_storage_order()))
+          throw Exception(getPath(), "appendRows requires a row-major matrix");
+        appendRows(data.data(), data.shape()[0], data.shape()[1]);
+      }
+
+      /** \brief Append a data vector in place
+       *
+       * Returns a pointer to the next free row in the cache. The row is appended to the dataset and must be filled
+       * with getColumns() elements by the caller before any other function of this object is called.
+       * A flush of the file (e.g. an auto-flush triggered by another dataset) does not write this row until the next call.
+       * This avoids copying the data if the caller can compute it directly into the cache.
+       * Only available if the dataset has a cache (Options::cacheSize>1) and T is not std::string.
+       */
+      T* appendSlot();
+
       /** \brief Returns the number of rows in the dataset */
       inline int getRows();
 
@@ -137,12 +249,83 @@ namespace H5 {
         return data;
       }
 
+      /** \brief Returns many data vectors
+       *
+       * Reads the rows [\a firstRow, \a firstRow+\a nrRows[ by one HDF5 call (e.g. the last rows of a dataset).
+       * \a data points to an array of nrRows*size elements which is filled row-major; \a size must be getColumns().
+       */
+      void getRows(size_t firstRow, size_t nrRows, size_t size, T data[]);
+
+      //! A range over rows of a VectorSerie which are read in blocks, see getRowRange
+      class RowRange {
+        public:
+          class Iterator {
+            public:
+              using iterator_category = std::input_iterator_tag;
+              using value_type = const T*;
+              using difference_type = std::ptrdiff_t;
+              using pointer = void;
+              using reference = const T*;
+              Iterator(RowRange *range_, size_t row_) : range(range_), row(row_) {}
+              //! the data of the current row (getColumns() elements, valid until the iterator is incremented)
+              const T* operator*() const { return range->getRowData(row); }
+              Iterator& operator++() { ++row; return *this; }
+              bool operator==(const Iterator &b) const { return row==b.row; }
+              bool operator!=(const Iterator &b) const { return row!=b.row; }
+              //! the row number of the current row
+              size_t getRow() const { return row; }
+            private:
+              RowRange *range;
+              size_t row;
+          };
+          RowRange(VectorSerie<T> *ds_, size_t firstRow_, size_t nrRows, size_t blockRows_, bool prefetch_);
+          RowRange(const RowRange&) = delete;
+          RowRange& operator=(const RowRange&) = delete;
+          //! waits for a running prefetch
+          ~RowRange();
+          Iterator begin() { return {this, firstRow}; }
+          Iterator end() { return {this, endRow}; }
+        private:
+          const T* getRowData(size_t row);
+          void readBlock(size_t first, std::vector<T> &data);
+          size_t blockEnd(size_t first) const { return std::min(endRow, (first/blockRows+1)*blockRows); }
+          VectorSerie<T> *ds;
+          size_t firstRow, endRow, blockRows;
+          bool prefetch;
+          ScopedHID fileSpaceID; // a own dataspace for the selection (the prefetch thread must not use the one of ds)
+          std::vector<T> block, nextBlock;
+          size_t blockFirst { std::numeric_limits<size_t>::max() }; // the first row in block
+          size_t nextFirst { std::numeric_limits<size_t>::max() }; // the first row in nextBlock
+          std::future<void> next; // the running prefetch of nextBlock
+      };
+
+      /** \brief Returns a range for sequential reading of the rows [\a firstRow, \a firstRow+\a nrRows[
+       *
+       * The rows are read in blocks of \a blockRows rows (0 = the chunk size of the dataset) by one HDF5 call each:
+       * for(const T *row : ts->getRowRange()) { ... row[0] ... row[ts->getColumns()-1] ... }
+       * If \a prefetch is true the next block is read by a background thread while the current block is processed
+       * (only if the HDF5 library is thread-safe).
+       * The range must not be used after the dataset is closed.
+       */
+      RowRange getRowRange(size_t firstRow=0, size_t nrRows=std::numeric_limits<size_t>::max(), size_t blockRows=0,
+                           bool prefetch=false) {
+        return RowRange(this, firstRow, nrRows, blockRows, prefetch);
+      }
+
       /** \brief Returns the data vector at column \a column
        *
        * The first column is 0. The last avaliable column ist getColumns()-1.
        */
       void getColumn(int column, size_t size, T data[]);
 
+      /** \brief Returns a part of the data vector at column \a column
+       *
+       * Reads \a nrRows elements of column \a column starting at row \a firstRow and taking each \a stride-th row
+       * (e.g. stride=100 for a decimated preview of a large dataset).
+       * Only the selected rows are transfered by HDF5. \a data points to an array of \a nrRows elements.
+       */
+      void getColumn(int column, size_t firstRow, size_t nrRows, size_t stride, T data[]);
+
       /** Convinience getRow function.
        * DataType must provide a "size_t size()" member function which returns the number of elements
        * as well as a "T &operator[](int i)" member function which returns a reference to the i-te element.
@@ -161,6 +344,100 @@ namespace H5 {
         return data;
       }
 
+      /** Convinience strided getColumn function.
+       * Returns a copy of each \a stride-th row of column \a column (starting at row \a firstRow) in form of a std::vector<T>. */
+      std::vector<T> getColumn(int column, size_t firstRow, size_t stride) {
+        size_t rows=getRows();
+        std::vector<T> data(stride>0 && firstRow<rows ? (rows-firstRow+stride-1)/stride : 0);
+        getColumn(column, firstRow, data.size(), stride, data.data());
+        return data;
+      }
+
+      /** \brief Returns the data of many columns
+       *
+       * Reads the rows [\a firstRow, \a firstRow+\a nrRows[ of all columns \a columns (0-based, any order, duplicates allowed)
+       * to \a data which must point to an array of columns.size()*nrRows elements.
+       * The data is stored column-major: column \a columns[i] starts at data[i*nrRows].
+       * All columns are read by a single pass over the chunks of the dataset (each chunk is read and decompressed only once)
+       * which is much faster than calling getColumn for each column.
+       */
+      void getColumns(const std::vector<int> &columns, size_t firstRow, size_t nrRows, T data[]);
+
+      /** Convinience getColumns function.
+       * Returns a copy of all rows of the columns \a columns in form of a std::vector<T> for each column. */
+      std::vector<std::vector<T>> getColumns(const std::vector<int> &columns) {
+        size_t rows=getRows();
+        std::vector<T> data(columns.size()*rows);
+        getColumns(columns, 0, rows, data.data());
+        std::vector<std::vector<T>> ret(columns.size());
+        for(size_t i=0; i<columns.size(); ++i)
+          ret[i].assign(std::make_move_iterator(data.begin()+i*rows), std::make_move_iterator(data.begin()+(i+1)*rows));
+        return ret;
+      }
+
+      /** \brief Returns the rows appended since the last call
+       *
+       * For readers following a dataset written by another process (SWMR, after File::refresh()).
+       * \a lastSeen is the number of rows the caller has already read (start with 0); it is set to getRows().
+       * The new rows are appended row-major to \a data and the number of new rows is returned.
+       * If the dataset has fewer rows than \a lastSeen (it was rewritten) \a data is cleared and all rows are read again.
+       */
+      size_t getRowsSince(size_t &lastSeen, std::vector<T> &data);
+
+      /** \brief Returns the new elements of many columns since the last call
+       *
+       * Same as getRowsSince but only the columns \a columns are read (by one getColumns call):
+       * the new elements of column \a columns[i] are appended to \a data[i] (\a data is resized to columns.size()).
+       */
+      size_t getColumnsSince(const std::vector<int> &columns, size_t &lastSeen, std::vector<std::vector<T>> &data);
+
+      /** \brief Returns the number of levels of the summary pyramid (0 if the dataset has no summary) */
+      int getSummaryLevels();
+
+      /** \brief Returns the number of rows summarized by a block of level 0 of the summary pyramid */
+      size_t getSummaryBlockRows();
+
+      /** \brief Returns the summary of column \a column at level \a level
+       *
+       * Returns the min, max and mean of column \a column for each block of getSummaryBlockRows()*2^level rows.
+       * The last element summarizes the remaining rows (if any) and is computed from the lower levels and the dataset.
+       * Only kilobytes are read for an overview of huge datasets. Only available for real number types.
+       */
+      void getSummary(int level, int column, std::vector<double> &min, std::vector<double> &max, std::vector<double> &mean);
+
+      //! A chunk of the dataset in the read-only memory mapping of the file (see mapChunk)
+      struct MappedChunk {
+        const T *data { nullptr }; // the element (firstRow, firstColumn)
+        size_t firstRow { 0 }, nrRows { 0 }; // the rows of the dataset in this chunk
+        size_t firstColumn { 0 }, nrColumns { 0 }; // the columns of the dataset in this chunk
+        size_t rowStride { 0 }; // the number of elements from one row to the next
+        //! the element at row \a row and column \a column of the dataset (must be in this chunk)
+        const T& operator()(size_t row, size_t column) const { return data[(row-firstRow)*rowStride+column-firstColumn]; }
+      };
+
+      /** \brief Zero-copy access to the chunk containing row \a row and column \a column
+       *
+       * The file is mapped read-only to memory and \a chunk is set to the chunk in this mapping, without any copy
+       * or type conversion. This is only possible for files opened for reading with the default (sec2) driver,
+       * datasets without filters (Options::compression=0) and if the type in the file is the native type T;
+       * false is returned otherwise, if the chunk is not written yet or if it is not aligned (use getRow, getColumn, ... then).
+       * HDF5 aligns the chunks only if the dataset was created with Options::alignChunks or Options::directChunkWrite.
+       * The data is valid until the next call of mapChunk/mapRow (the file is remapped if it has grown) or close.
+       */
+      bool mapChunk(size_t row, size_t column, MappedChunk &chunk);
+
+      /** \brief Zero-copy access to row \a row
+       *
+       * Returns a pointer to the getColumns() elements of row \a row in the memory mapped file or nullptr if not possible
+       * (see mapChunk; additionally the chunks must contain all columns, see Options::chunkColumns).
+       */
+      const T* mapRow(size_t row) {
+        MappedChunk chunk;
+        if(chunkColumns<dims[1] || !mapChunk(row, 0, chunk))
+          return nullptr;
+        return &chunk(row, 0);
+      }
+
       /** \brief Return the description for the dataset
        *
        * Returns the value of the string attribute named \p Description of the dataset.
@@ -183,7 +460,12 @@ namespace H5 {
 
   template<class T>
   int VectorSerie<T>::getRows() {
+    waitForAsyncWrite();
+    if(rowCount<0 && extent>dims[0]) // a writer with reserved extent: dims[0] is the number of written rows
+      return dims[0];
     checkCall(H5Sget_simple_extent_dims(fileDataSpaceID, dims, nullptr));
+    if(rowCount>=0 && static_cast<hsize_t>(rowCount)<dims[0]) // a reader of a dataset with rows reserved by the writer
+      dims[0]=rowCount;
     return dims[0];
   }
 